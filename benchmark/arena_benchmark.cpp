@@ -0,0 +1,96 @@
+#include <memory>
+#include <utility>
+
+#include "benchmark.h"
+#include "scene_graph/circle.h"
+#include "scene_graph/node_arena.h"
+#include "scene_graph/rectangle.h"
+#include "scene_graph/transform_batch.h"
+
+namespace benchmark {
+
+namespace {
+
+constexpr std::size_t kCarCount = 20000;
+constexpr std::size_t kNodesPerCar = 10;
+
+// Allocates from the arena if there is one, from the heap otherwise
+template <typename T, typename... Args>
+std::shared_ptr<T> create(scene_graph::NodeArena* arena, Args&&... args) {
+    if (arena) {
+        return arena->create<T>(std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Build cars shaped like Application::createCar: a car node with a
+ * body, roof, four wheels and a hubcap per wheel.
+ */
+scene_graph::NodePtr buildScene(scene_graph::NodeArena* arena) {
+    using scene_graph::Circle;
+    using scene_graph::Node;
+    using scene_graph::Rectangle;
+
+    auto root = create<Node>(arena, "Root");
+    for (std::size_t i = 0; i < kCarCount; ++i) {
+        auto car = create<Node>(arena, "Car");
+        car->setPosition(Vector2(static_cast<float>(i % 100), static_cast<float>(i / 100)));
+        root->addChild(car);
+
+        auto body = create<Rectangle>(arena, "Car_Body", Vector2(2.0F, 1.0F));
+        car->addChild(body);
+        body->addChild(create<Rectangle>(arena, "Car_Roof", Vector2(1.0F, 0.5F)));
+        for (int w = 0; w < 4; ++w) {
+            auto wheel = create<Circle>(arena, "Car_Wheel", 0.3F);
+            wheel->setPosition(Vector2(static_cast<float>(w) - 1.5F, -0.5F));
+            body->addChild(wheel);
+            wheel->addChild(create<Circle>(arena, "Car_Hubcap", 0.1F));
+        }
+    }
+    return root;
+}
+
+}  // namespace
+
+void runArenaBenchmarks() {
+    const int iterations = 10;
+    const std::size_t nodeCount = kCarCount * kNodesPerCar + 1;
+
+    double ms = measureMilliseconds([]() { buildScene(nullptr); }, iterations);
+    report("make_shared build + teardown", nodeCount, ms);
+
+    ms = measureMilliseconds(
+        []() {
+            scene_graph::NodeArena arena;
+            buildScene(&arena);
+        },
+        iterations);
+    report("NodeArena build + teardown", nodeCount, ms);
+
+    // Traversal cost depends on where the nodes ended up in memory
+    auto heapRoot = buildScene(nullptr);
+    scene_graph::WorldTransformUpdater updater;
+    float offset = 0.0F;
+    ms = measureMilliseconds(
+        [&]() {
+            offset += 1.0F;
+            heapRoot->setPosition(Vector2(offset, 0.0F));
+            updater.update(*heapRoot);
+        },
+        iterations);
+    report("make_shared batched update", nodeCount, ms);
+
+    scene_graph::NodeArena arena;
+    auto arenaRoot = buildScene(&arena);
+    ms = measureMilliseconds(
+        [&]() {
+            offset += 1.0F;
+            arenaRoot->setPosition(Vector2(offset, 0.0F));
+            updater.update(*arenaRoot);
+        },
+        iterations);
+    report("NodeArena batched update", nodeCount, ms);
+}
+
+}  // namespace benchmark
@@ -0,0 +1,45 @@
+#ifndef BENCHMARK_BENCHMARK_H
+#define BENCHMARK_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace benchmark {
+
+/**
+ * @brief Run a callable a number of times and return the mean time in ms.
+ *
+ * One untimed warm-up run is done first so the first-touch page faults of
+ * freshly built scenes do not end up in the measurement.
+ */
+template <typename Fn>
+double measureMilliseconds(Fn&& fn, int iterations) {
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return elapsed.count() / iterations;
+}
+
+inline void report(const std::string& name, std::size_t nodeCount, double milliseconds) {
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << nodeCount
+              << " nodes " << std::setw(12) << std::fixed << std::setprecision(3) << milliseconds
+              << " ms" << std::endl;
+}
+
+// Benchmark suites, one per benchmark source file
+void runTransformBenchmarks();
+void runParallelBenchmarks();
+void runArenaBenchmarks();
+void runHitTestBenchmarks();
+void runRecordBenchmarks();
+
+}  // namespace benchmark
+
+#endif  // BENCHMARK_BENCHMARK_H
@@ -0,0 +1,72 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"
+#include "scene_graph/rectangle.h"
+#include "scene_graph/shape_bvh.h"
+
+namespace benchmark {
+
+namespace {
+
+constexpr int kQueries = 1000;
+
+// Query points spread over the whole scene, most of them on a shape
+Vector2 queryPoint(int i, int columns, int rows) {
+    return Vector2(static_cast<float>((i * 37) % columns) + 0.25F,
+                   static_cast<float>((i * 91) % rows) + 0.25F);
+}
+
+}  // namespace
+
+void runHitTestBenchmarks() {
+    for (int columns : {100, 250}) {
+        const int rows = 200;
+        const auto shapeCount = static_cast<std::size_t>(columns) * rows;
+
+        std::vector<std::shared_ptr<scene_graph::Rectangle>> owned;
+        std::vector<scene_graph::Shape*> shapes;
+        owned.reserve(shapeCount);
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < columns; ++x) {
+                auto rect = std::make_shared<scene_graph::Rectangle>("Rect", Vector2(0.8F));
+                rect->setPosition(Vector2(static_cast<float>(x), static_cast<float>(y)));
+                rect->setRotation(static_cast<float>((x * 7 + y * 3) % 90));
+                shapes.push_back(rect.get());
+                owned.push_back(std::move(rect));
+            }
+        }
+
+        double ms = measureMilliseconds(
+            [&]() {
+                for (int i = 0; i < kQueries; ++i) {
+                    const Vector2 point = queryPoint(i, columns, rows);
+                    for (scene_graph::Shape* shape : shapes) {
+                        if (shape->containsPoint(point)) {
+                            break;
+                        }
+                    }
+                }
+            },
+            3);
+        report("Linear hit test, 1000 queries", shapeCount, ms);
+
+        scene_graph::ShapeBvh bvh;
+        ms = measureMilliseconds([&]() { bvh.build(shapes); }, 10);
+        report("BVH build", shapeCount, ms);
+
+        ms = measureMilliseconds([&]() { bvh.refit(); }, 10);
+        report("BVH refit", shapeCount, ms);
+
+        ms = measureMilliseconds(
+            [&]() {
+                for (int i = 0; i < kQueries; ++i) {
+                    static_cast<void>(bvh.hitTest(queryPoint(i, columns, rows)));
+                }
+            },
+            10);
+        report("BVH hit test, 1000 queries", shapeCount, ms);
+    }
+}
+
+}  // namespace benchmark
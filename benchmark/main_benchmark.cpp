@@ -0,0 +1,43 @@
+#include <cstring>
+#include <iostream>
+
+#include "benchmark.h"
+
+/**
+ * Usage: scene_graphs_benchmarks [suite]
+ *
+ * Runs every suite, or only the one whose name is given.
+ */
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    auto selected = [filter](const char* name) {
+        return filter == nullptr || std::strcmp(filter, name) == 0;
+    };
+
+    if (selected("transform")) {
+        std::cout << "== transform ==" << std::endl;
+        benchmark::runTransformBenchmarks();
+    }
+
+    if (selected("parallel")) {
+        std::cout << "== parallel ==" << std::endl;
+        benchmark::runParallelBenchmarks();
+    }
+
+    if (selected("arena")) {
+        std::cout << "== arena ==" << std::endl;
+        benchmark::runArenaBenchmarks();
+    }
+
+    if (selected("hittest")) {
+        std::cout << "== hittest ==" << std::endl;
+        benchmark::runHitTestBenchmarks();
+    }
+
+    if (selected("record")) {
+        std::cout << "== record ==" << std::endl;
+        benchmark::runRecordBenchmarks();
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "benchmark.h"
+#include "scene_graph/node.h"
+#include "scene_graph/task_scheduler.h"
+#include "scene_graph/transform_batch.h"
+
+namespace benchmark {
+
+namespace {
+
+/**
+ * @brief Build a wide scene shaped like Application::createCar, repeated.
+ *
+ * Each car is a body with four wheels and a hubcap per wheel, all directly
+ * or indirectly under one root.
+ */
+scene_graph::NodePtr buildCarScene(std::size_t carCount) {
+    auto root = std::make_shared<scene_graph::Node>("Root");
+    for (std::size_t i = 0; i < carCount; ++i) {
+        auto car = std::make_shared<scene_graph::Node>("Car");
+        car->setPosition(Vector2(static_cast<float>(i % 100), static_cast<float>(i / 100)));
+        root->addChild(car);
+
+        auto body = std::make_shared<scene_graph::Node>("Body");
+        car->addChild(body);
+        for (int w = 0; w < 4; ++w) {
+            auto wheel = std::make_shared<scene_graph::Node>("Wheel");
+            wheel->setPosition(Vector2(static_cast<float>(w) - 1.5F, -0.5F));
+            wheel->setRotation(static_cast<float>(w) * 30.0F);
+            body->addChild(wheel);
+
+            auto hubcap = std::make_shared<scene_graph::Node>("Hubcap");
+            hubcap->setScale(Vector2(0.5F, 0.5F));
+            wheel->addChild(hubcap);
+        }
+    }
+    return root;
+}
+
+void benchmarkSerial(const scene_graph::NodePtr& root, int iterations) {
+    scene_graph::WorldTransformUpdater updater;
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            // Moving the root invalidates every world transform below it
+            offset += 1.0F;
+            root->setPosition(Vector2(offset, 0.0F));
+            updater.update(*root);
+        },
+        iterations);
+    report("Serial batched update", root->getSubtreeSize(), ms);
+}
+
+void benchmarkParallel(const scene_graph::NodePtr& root, std::size_t threads, int iterations) {
+    scene_graph::TaskScheduler scheduler(threads);
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            offset += 1.0F;
+            root->setPosition(Vector2(offset, 0.0F));
+            scene_graph::updateWorldTransforms(*root, scheduler);
+        },
+        iterations);
+    report("Parallel update, " + std::to_string(threads) + " threads", root->getSubtreeSize(), ms);
+}
+
+}  // namespace
+
+void runParallelBenchmarks() {
+    const std::size_t carCounts[] = {1000, 20000, 100000};
+    const int iterations[] = {50, 10, 3};
+    const std::size_t maxThreads = std::max(1U, std::thread::hardware_concurrency());
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        auto root = buildCarScene(carCounts[i]);
+        benchmarkSerial(root, iterations[i]);
+
+        // 1, 2, 4, ... threads, always ending with all hardware threads
+        for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+            benchmarkParallel(root, threads, iterations[i]);
+        }
+        benchmarkParallel(root, maxThreads, iterations[i]);
+    }
+}
+
+}  // namespace benchmark
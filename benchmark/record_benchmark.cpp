@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "benchmark.h"
+#include "scene_graph/circle.h"
+#include "scene_graph/node.h"
+#include "scene_graph/rectangle.h"
+#include "scene_graph/task_scheduler.h"
+#include "visualization/canvas.h"
+#include "visualization/renderer.h"
+
+namespace benchmark {
+
+namespace {
+
+/**
+ * @brief Build cars of shapes, a rectangle body with four circle wheels,
+ * spread over the visible region so nothing is culled.
+ */
+scene_graph::NodePtr buildShapeScene(std::size_t carCount) {
+    auto root = std::make_shared<scene_graph::Node>("Root");
+    for (std::size_t i = 0; i < carCount; ++i) {
+        auto car = std::make_shared<scene_graph::Node>("Car");
+        car->setPosition(Vector2(static_cast<float>(i % 100) * 0.18F - 9.0F,
+                                 static_cast<float>(i / 100 % 100) * 0.1F - 5.0F));
+        root->addChild(car);
+
+        auto body = std::make_shared<scene_graph::Rectangle>("Body", Vector2(0.1F, 0.04F));
+        car->addChild(body);
+        for (int w = 0; w < 4; ++w) {
+            auto wheel = std::make_shared<scene_graph::Circle>("Wheel", 0.01F);
+            wheel->setPosition(Vector2(static_cast<float>(w) * 0.02F - 0.03F, -0.02F));
+            body->addChild(wheel);
+        }
+    }
+    return root;
+}
+
+void benchmarkRecord(const scene_graph::NodePtr& root, std::size_t threads, int iterations) {
+    auto renderer = std::make_shared<visualization::Renderer>();
+    renderer->setHeadlessMode(true);
+    renderer->initialize();
+
+    visualization::Canvas canvas;
+    canvas.initialize(renderer);
+    canvas.setRoot(root);
+    canvas.setTaskScheduler(std::make_shared<scene_graph::TaskScheduler>(threads));
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            // Moving the root invalidates every world transform and bound
+            offset = offset > 0.0F ? 0.0F : 0.01F;
+            root->setPosition(Vector2(offset, 0.0F));
+            canvas.render();
+        },
+        iterations);
+    report("Canvas::render, " + std::to_string(threads) + " threads", root->getSubtreeSize(),
+           ms);
+}
+
+}  // namespace
+
+void runRecordBenchmarks() {
+    const std::size_t carCounts[] = {1000, 10000};
+    const int iterations[] = {50, 10};
+    const std::size_t maxThreads = std::max(1U, std::thread::hardware_concurrency());
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        auto root = buildShapeScene(carCounts[i]);
+
+        // 1, 2, 4, ... threads, always ending with all hardware threads
+        for (std::size_t threads = 1; threads < maxThreads; threads *= 2) {
+            benchmarkRecord(root, threads, iterations[i]);
+        }
+        benchmarkRecord(root, maxThreads, iterations[i]);
+    }
+}
+
+}  // namespace benchmark
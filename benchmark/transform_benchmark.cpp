@@ -0,0 +1,106 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scene_storage.h"
+#include "scene_graph/transform_batch.h"
+
+namespace benchmark {
+
+namespace {
+
+// Each node has up to four children, giving ~10 levels at 1M nodes
+constexpr std::size_t kBranchingFactor = 4;
+
+/**
+ * @brief Build a complete 4-ary Node hierarchy with the given node count.
+ *
+ * Nodes are created in breadth-first order, so nodes[i]'s parent is
+ * nodes[(i - 1) / kBranchingFactor].
+ */
+std::vector<scene_graph::NodePtr> buildNodeTree(std::size_t count) {
+    std::vector<scene_graph::NodePtr> nodes;
+    nodes.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto node = std::make_shared<scene_graph::Node>("Node");
+        node->setPosition(Vector2(0.5F, 0.25F));
+        node->setRotation(static_cast<float>(i % 360));
+        if (i > 0) {
+            nodes[(i - 1) / kBranchingFactor]->addChild(node);
+        }
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+void benchmarkNodeHierarchy(std::size_t count, int iterations) {
+    auto nodes = buildNodeTree(count);
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            // Moving the root invalidates every world transform below it
+            offset += 1.0F;
+            nodes.front()->setPosition(Vector2(offset, 0.0F));
+            for (const auto& node : nodes) {
+                node->getGlobalMatrix();
+            }
+        },
+        iterations);
+    report("Node/Transform update", count, ms);
+}
+
+void benchmarkBatchedNodeHierarchy(std::size_t count, int iterations) {
+    auto nodes = buildNodeTree(count);
+    scene_graph::WorldTransformUpdater updater;
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            offset += 1.0F;
+            nodes.front()->setPosition(Vector2(offset, 0.0F));
+            updater.update(*nodes.front());
+        },
+        iterations);
+    report("Node/Transform batched update", count, ms);
+}
+
+void benchmarkSceneStorage(std::size_t count, int iterations) {
+    scene_graph::SceneStorage storage;
+    storage.reserve(count);
+    scene_graph::Transform local;
+    local.setPosition(Vector2(0.5F, 0.25F));
+    for (std::size_t i = 0; i < count; ++i) {
+        local.setRotation(static_cast<float>(i % 360));
+        auto parent = i == 0 ? scene_graph::SceneStorage::kInvalidSlot
+                             : static_cast<scene_graph::SceneStorage::Slot>(
+                                   (i - 1) / kBranchingFactor);
+        storage.add(parent, local);
+    }
+    float offset = 0.0F;
+
+    double ms = measureMilliseconds(
+        [&]() {
+            offset += 1.0F;
+            storage.setPosition(0, Vector2(offset, 0.0F));
+            storage.updateWorldTransforms();
+        },
+        iterations);
+    report("SceneStorage SoA update", count, ms);
+}
+
+}  // namespace
+
+void runTransformBenchmarks() {
+    const std::size_t counts[] = {10000, 100000, 1000000};
+    const int iterations[] = {50, 10, 3};
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        benchmarkNodeHierarchy(counts[i], iterations[i]);
+        benchmarkBatchedNodeHierarchy(counts[i], iterations[i]);
+        benchmarkSceneStorage(counts[i], iterations[i]);
+    }
+}
+
+}  // namespace benchmark
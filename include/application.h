@@ -6,6 +6,7 @@
 
 #include "constants.h"
 #include "scene_graph/node.h"
+#include "scene_graph/node_arena.h"
 #include "types.h"
 #include "visualization/canvas.h"
 #include "visualization/renderer.h"
@@ -53,6 +54,10 @@ private:
     // Animation
     void updateAnimations(float deltaTime);
 
+    // Storage for all scene nodes; declared first so it outlives every
+    // component that holds on to nodes
+    scene_graph::NodeArena nodeArena_;
+
     // Components
     std::unique_ptr<visualization::Window> window_;
     std::shared_ptr<visualization::Renderer> renderer_;
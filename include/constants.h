@@ -184,6 +184,10 @@ inline constexpr float TREE_NODE_CONNECTOR_PADDING = 0.1f;
  */
 /// Font size for text
 inline constexpr int TEXT_FONT_SIZE = 24;
+/// Font size distance field glyphs are rasterized at; drawn at TEXT_FONT_SIZE
+inline constexpr int TEXT_DISTANCE_FIELD_FONT_SIZE = 48;
+/// Pixels a glyph's distance field extends past its outline
+inline constexpr int TEXT_DISTANCE_FIELD_SPREAD = 6;
 /// Global scale for text rendering
 inline constexpr float TEXT_SCALE = 0.012f;
 /// Horizontal padding for text
@@ -194,8 +198,6 @@ inline constexpr float TEXT_PADDING_Y = 0.1f;
 inline constexpr float TREE_NODE_HEIGHT = 0.7f;
 /// Vertical offset to center text in tree nodes
 inline constexpr float TREE_TEXT_VERT_OFFSET = 0.1f;
-/// Character width scaling factor for text
-inline constexpr float TEXT_CHAR_WIDTH_FACTOR = 0.25f;
 /// Fixed padding for text width calculation
 inline constexpr float TEXT_WIDTH_PADDING = 0.6f;
 
@@ -0,0 +1,85 @@
+#ifndef SCENE_GRAPH_AABB_H
+#define SCENE_GRAPH_AABB_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "scene_graph/affine2.h"
+#include "types.h"
+
+namespace scene_graph {
+
+/**
+ * @brief An axis-aligned bounding box.
+ *
+ * A default-constructed box is empty: it contains nothing and merging it
+ * into another box is a no-op. infinite() is the opposite and contains
+ * every point.
+ */
+struct Aabb {
+    Vector2 min = Vector2(std::numeric_limits<float>::max());
+    Vector2 max = Vector2(std::numeric_limits<float>::lowest());
+
+    static Aabb fromCenterExtents(const Vector2& center, const Vector2& halfExtents) {
+        return {center - halfExtents, center + halfExtents};
+    }
+
+    static Aabb infinite() {
+        return {Vector2(std::numeric_limits<float>::lowest()),
+                Vector2(std::numeric_limits<float>::max())};
+    }
+
+    [[nodiscard]] bool isEmpty() const {
+        return min.x > max.x || min.y > max.y;
+    }
+
+    [[nodiscard]] bool isInfinite() const {
+        return min.x == std::numeric_limits<float>::lowest() &&
+               min.y == std::numeric_limits<float>::lowest() &&
+               max.x == std::numeric_limits<float>::max() &&
+               max.y == std::numeric_limits<float>::max();
+    }
+
+    [[nodiscard]] bool contains(const Vector2& point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+
+    [[nodiscard]] bool intersects(const Aabb& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y &&
+               max.y >= other.min.y;
+    }
+
+    [[nodiscard]] Vector2 getCenter() const {
+        return (min + max) * 0.5F;
+    }
+
+    [[nodiscard]] Vector2 getSize() const {
+        return max - min;
+    }
+
+    void merge(const Aabb& other) {
+        min.x = std::min(min.x, other.min.x);
+        min.y = std::min(min.y, other.min.y);
+        max.x = std::max(max.x, other.max.x);
+        max.y = std::max(max.y, other.max.y);
+    }
+
+    /// Bounds of this box after mapping it through an affine transform
+    [[nodiscard]] Aabb transformed(const Affine2& matrix) const {
+        if (isEmpty() || isInfinite()) {
+            return *this;
+        }
+        // Transform the center, then grow by the absolute linear part applied
+        // to the half extents; exact for the four corners of the box
+        const Vector2 center = matrix.transformPoint(getCenter());
+        const Vector2 half = getSize() * 0.5F;
+        const Vector2 extents(std::abs(matrix.a) * half.x + std::abs(matrix.c) * half.y,
+                              std::abs(matrix.b) * half.x + std::abs(matrix.d) * half.y);
+        return fromCenterExtents(center, extents);
+    }
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_AABB_H
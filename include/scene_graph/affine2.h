@@ -0,0 +1,108 @@
+#ifndef SCENE_GRAPH_AFFINE2_H
+#define SCENE_GRAPH_AFFINE2_H
+
+#include "types.h"
+
+namespace scene_graph {
+
+/**
+ * @brief A 2D affine transformation stored as a 3x2 matrix (6 floats).
+ *
+ * Every transform in the scene graph is a 2D affine map, so the full 4x4
+ * matrix is never needed on the CPU. Points map as
+ *
+ *     x' = a * x + c * y + tx
+ *     y' = b * x + d * y + ty
+ *
+ * i.e. (a, b) and (c, d) are the images of the x and y axes and (tx, ty) is
+ * the translation. Composition, inversion and point transforms are closed
+ * form. A Matrix4 is only built by toMatrix4() where one has to be handed to
+ * the GPU.
+ */
+struct Affine2 {
+    float a = 1.0F;
+    float b = 0.0F;
+    float c = 0.0F;
+    float d = 1.0F;
+    float tx = 0.0F;
+    float ty = 0.0F;
+
+    /**
+     * @brief Build a Translate * Rotate * Scale matrix from its components.
+     *
+     * Takes the rotation as its cosine and sine so callers that already have
+     * them do not pay for trig again.
+     */
+    static Affine2 fromTRS(const Vector2& position, float cosTheta, float sinTheta,
+                           const Vector2& scale) {
+        return {scale.x * cosTheta, scale.x * sinTheta, -scale.y * sinTheta,
+                scale.y * cosTheta, position.x,         position.y};
+    }
+
+    /// Extract the 2D affine part of a 4x4 matrix
+    static Affine2 fromMatrix4(const Matrix4& matrix) {
+        return {matrix[0][0], matrix[0][1], matrix[1][0],
+                matrix[1][1], matrix[3][0], matrix[3][1]};
+    }
+
+    /// Expand to a 4x4 matrix for GPU upload
+    [[nodiscard]] Matrix4 toMatrix4() const {
+        Matrix4 matrix(1.0F);
+        matrix[0][0] = a;
+        matrix[0][1] = b;
+        matrix[1][0] = c;
+        matrix[1][1] = d;
+        matrix[3][0] = tx;
+        matrix[3][1] = ty;
+        return matrix;
+    }
+
+    [[nodiscard]] float determinant() const {
+        return a * d - b * c;
+    }
+
+    [[nodiscard]] Vector2 transformPoint(const Vector2& point) const {
+        return {a * point.x + c * point.y + tx, b * point.x + d * point.y + ty};
+    }
+
+    /// Equivalent to multiplying by a scale matrix on the right
+    [[nodiscard]] Affine2 scaled(const Vector2& scale) const {
+        return {a * scale.x, b * scale.x, c * scale.y, d * scale.y, tx, ty};
+    }
+
+    [[nodiscard]] Affine2 inverse() const {
+        const float invDet = 1.0F / determinant();
+        const float ia = d * invDet;
+        const float ib = -b * invDet;
+        const float ic = -c * invDet;
+        const float id = a * invDet;
+        return {ia, ib, ic, id, -(ia * tx + ic * ty), -(ib * tx + id * ty)};
+    }
+
+    /// Map a point through the inverse without building the inverse matrix
+    [[nodiscard]] Vector2 inverseTransformPoint(const Vector2& point) const {
+        const float invDet = 1.0F / determinant();
+        const float px = point.x - tx;
+        const float py = point.y - ty;
+        return {(d * px - c * py) * invDet, (a * py - b * px) * invDet};
+    }
+};
+
+/**
+ * @brief Compose two affine transforms.
+ *
+ * The result applies child first, then parent, matching
+ * parent.toMatrix4() * child.toMatrix4().
+ */
+inline Affine2 operator*(const Affine2& parent, const Affine2& child) {
+    return {parent.a * child.a + parent.c * child.b,
+            parent.b * child.a + parent.d * child.b,
+            parent.a * child.c + parent.c * child.d,
+            parent.b * child.c + parent.d * child.d,
+            parent.a * child.tx + parent.c * child.ty + parent.tx,
+            parent.b * child.tx + parent.d * child.ty + parent.ty};
+}
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_AFFINE2_H
@@ -0,0 +1,126 @@
+#ifndef SCENE_GRAPH_CHILD_LIST_H
+#define SCENE_GRAPH_CHILD_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace scene_graph {
+
+class Node;
+
+/**
+ * @brief The children of a Node, with room for a few of them inline.
+ *
+ * Most nodes in a scene are leaves or have only a couple of children, so up
+ * to kInlineCapacity children are stored inside the list itself and only
+ * larger families spill to a buffer from the list's memory resource. Every
+ * inline slot costs 16 bytes on every leaf, hence the small capacity. Once
+ * spilled, the list keeps its buffer until it is destroyed.
+ *
+ * Supports the subset of the std::vector interface the scene graph uses;
+ * iterators are plain pointers and are invalidated by push_back().
+ */
+class ChildList {
+public:
+    using value_type = std::shared_ptr<Node>;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr std::uint32_t kInlineCapacity = 2;
+
+    explicit ChildList(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~ChildList();
+
+    // delete copy and move constructors and assignment operators
+    ChildList(const ChildList&) = delete;
+    ChildList& operator=(const ChildList&) = delete;
+    ChildList(ChildList&&) = delete;
+    ChildList& operator=(ChildList&&) = delete;
+
+    iterator begin() {
+        return data();
+    }
+    iterator end() {
+        return data() + size_;
+    }
+    const_iterator begin() const {
+        return data();
+    }
+    const_iterator end() const {
+        return data() + size_;
+    }
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+    [[nodiscard]] std::size_t capacity() const {
+        return capacity_;
+    }
+    // True while the children fit in the inline storage
+    [[nodiscard]] bool isInline() const {
+        return capacity_ == kInlineCapacity;
+    }
+
+    value_type& operator[](std::size_t index) {
+        return data()[index];
+    }
+    const value_type& operator[](std::size_t index) const {
+        return data()[index];
+    }
+    const value_type& front() const {
+        return data()[0];
+    }
+    const value_type& back() const {
+        return data()[size_ - 1];
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* getResource() const {
+        return resource_;
+    }
+
+    void push_back(const value_type& child);
+    iterator erase(iterator first, iterator last);
+    void clear();
+
+private:
+    value_type* data() {
+        return isInline() ? std::launder(reinterpret_cast<value_type*>(inline_)) : heap_;
+    }
+    const value_type* data() const {
+        return isInline() ? std::launder(reinterpret_cast<const value_type*>(inline_)) : heap_;
+    }
+    void grow();
+
+    std::pmr::memory_resource* resource_;
+    union {
+        alignas(value_type) unsigned char inline_[kInlineCapacity * sizeof(value_type)];
+        value_type* heap_;
+    };
+    std::uint32_t size_ = 0;
+    std::uint32_t capacity_ = kInlineCapacity;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_CHILD_LIST_H
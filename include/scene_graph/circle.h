@@ -11,6 +11,8 @@ namespace scene_graph {
 class Circle : public Shape {
 public:
     Circle(const std::string& name, float radius = DEFAULT_RADIUS);
+    Circle(std::allocator_arg_t, const Allocator& allocator, const std::string& name,
+           float radius = DEFAULT_RADIUS);
     virtual ~Circle() = default;
 
     // Delete copy constructor and assignment operator
@@ -28,6 +30,7 @@ public:
     // Override virtual methods from Shape
     void render() const override;
     bool containsPoint(const Vector2& point) const override;
+    Aabb getLocalBounds() const override;
 
 private:
     float radius_;
@@ -1,65 +1,161 @@
 #ifndef SCENE_GRAPH_NODE_H
 #define SCENE_GRAPH_NODE_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
-#include <vector>
+#include <string_view>
 
+#include "scene_graph/aabb.h"
+#include "scene_graph/affine2.h"
+#include "scene_graph/child_list.h"
+#include "scene_graph/node_handle.h"
 #include "scene_graph/transform.h"
 #include "types.h"
 
 namespace scene_graph {
 
+/**
+ * @brief A node in the scene hierarchy.
+ *
+ * The layout is kept compact: the fields read on every transform update
+ * (transforms, handles, flags, children) come first, small families of
+ * children are stored inline, and the name, which only tools and the UI
+ * read, lives out of line.
+ */
 class Node : public std::enable_shared_from_this<Node> {
 public:
-    Node(std::string name);
+    // Allocator for the node's name and child list, see NodeArena
+    using Allocator = std::pmr::polymorphic_allocator<std::byte>;
+
+    static constexpr std::size_t kMaxNameLength = UINT16_MAX;
+
+    Node(std::string_view name);
+    Node(std::allocator_arg_t, const Allocator& allocator, std::string_view name);
     virtual ~Node();
 
-    const std::string& getName() const {
-        return name_;
-    }
-    void setName(const std::string& name) {
-        name_ = name;
+    // A node owns its registry slot, so it cannot be copied
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    std::string_view getName() const {
+        return {name_, nameLength_};
     }
+    void setName(std::string_view name);
 
-    // Hierarchy operations
-    std::weak_ptr<Node> getParent() const {
+    // Handle-based access: O(1) lookups without reference counting
+    NodeHandle getHandle() const {
+        return handle_;
+    }
+    NodeHandle getParentHandle() const {
         return parent_;
     }
-    const std::vector<std::shared_ptr<Node>>& getChildren() const {
+    Node* getParentNode() const {
+        return NodeRegistry::instance().get(parent_);
+    }
+
+    // Hierarchy operations
+    std::weak_ptr<Node> getParent() const;
+    const ChildList& getChildren() const {
         return children_;
     }
     void addChild(const std::shared_ptr<Node>& child);
     void removeChild(const std::shared_ptr<Node>& child);
 
+    // Number of nodes in this subtree, including this node
+    std::size_t getSubtreeSize() const {
+        return subtreeSize_;
+    }
+
     // Transform operations
     const Transform& getLocalTransform() const {
         return transform_;
     }
-    Transform& getLocalTransform() {
-        return transform_;
-    }
     void setLocalTransform(const Transform& transform) {
         transform_ = transform;
+        markGlobalTransformDirty();
     }
 
     Transform getGlobalTransform() const;
+    const Affine2& getGlobalMatrix() const;
+    bool isGlobalTransformDirty() const {
+        return globalTransformDirty_;
+    }
 
     void setPosition(const Vector2& position);
     Vector2 getPosition() const;
     void setRotation(float rotation);
     float getRotation() const;
+    void rotateBy(const Rotation2& delta);
     void setScale(const Vector2& scale);
     Vector2 getScale() const;
 
     bool hasParent(const std::shared_ptr<Node>& potentialParent) const;
     bool isOrphaned() const;
 
+    // Bounds in the node's own coordinate space; empty for plain nodes
+    virtual Aabb getLocalBounds() const;
+    // Bounds of this node alone under its world transform
+    Aabb getWorldBounds() const;
+    // World bounds of this node and all its descendants, cached
+    const Aabb& getSubtreeBounds() const;
+    bool isSubtreeBoundsDirty() const {
+        return subtreeBoundsDirty_;
+    }
+
+    // Moves whenever this node's world bounds may have changed, so caches
+    // of them (such as a hit test BVH) can update only the nodes that moved
+    std::uint32_t getBoundsRevision() const {
+        return boundsRevision_;
+    }
+
+    // Scene-wide change counters, so such caches can cheaply tell whether
+    // anything at all is stale. The scene bounds revision moves when any
+    // world transform or shape geometry may have changed, the hierarchy
+    // revision when any parent/child link changed.
+    static std::uint64_t getSceneBoundsRevision() {
+        return sceneBoundsRevision_.load(std::memory_order_relaxed);
+    }
+    static std::uint64_t getHierarchyRevision() {
+        return hierarchyRevision_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    // For subclasses whose extent changed without a transform change
+    void markBoundsChanged();
+
 private:
-    std::string name_;
-    std::weak_ptr<Node> parent_;
-    std::vector<std::shared_ptr<Node>> children_;
+    // Writes world transforms back in batches
+    friend class WorldTransformUpdater;
+
+    void markGlobalTransformDirty();
+    void markDescendantsDirty();
+    void markSubtreeBoundsDirty();
+    void adjustSubtreeSize(std::ptrdiff_t delta);
+
+    // Hot: touched by every transform update and traversal
     Transform transform_;  // Local transform only
+    // Cached world transform and subtree bounds, recomputed lazily when
+    // marked dirty
+    mutable Affine2 globalMatrix_;
+    mutable Aabb subtreeBounds_;
+    NodeHandle handle_;
+    NodeHandle parent_;
+    std::uint32_t subtreeSize_ = 1;
+    std::uint32_t boundsRevision_ = 0;
+    std::uint16_t nameLength_ = 0;
+    mutable bool globalTransformDirty_ = true;
+    mutable bool subtreeBoundsDirty_ = true;
+    ChildList children_;
+
+    // Cold: allocated from the same resource as the children
+    char* name_ = nullptr;
+
+    inline static std::atomic<std::uint64_t> sceneBoundsRevision_{0};
+    inline static std::atomic<std::uint64_t> hierarchyRevision_{0};
 };
 
 }  // namespace scene_graph
@@ -0,0 +1,64 @@
+#ifndef SCENE_GRAPH_NODE_ARENA_H
+#define SCENE_GRAPH_NODE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "scene_graph/node.h"
+
+namespace scene_graph {
+
+/**
+ * @brief Pooled storage for scene nodes.
+ *
+ * Nodes created through create() live, together with their shared_ptr control
+ * block, name and child list, in a size-class pool carved out of large
+ * chunks. Building a scene therefore costs a handful of bulk allocations,
+ * nodes created one after another (typically siblings) end up next to each
+ * other in memory, and freed node memory is recycled for the next node of the
+ * same size. Destroying the arena releases everything at once.
+ *
+ * The arena is not synchronized; create and destroy its nodes on one thread.
+ * It must outlive every node created from it.
+ */
+class NodeArena {
+public:
+    NodeArena();
+    ~NodeArena() = default;
+
+    // delete copy and move constructors and assignment operators
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    NodeArena(NodeArena&&) = delete;
+    NodeArena& operator=(NodeArena&&) = delete;
+
+    [[nodiscard]] std::pmr::memory_resource* getResource() {
+        return &pool_;
+    }
+
+    /**
+     * @brief Create a node of type T, e.g. Node, Rectangle or Circle.
+     *
+     * @param args Constructor arguments following the allocator
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        const Node::Allocator allocator(&pool_);
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&pool_),
+                                       std::allocator_arg, allocator,
+                                       std::forward<Args>(args)...);
+    }
+
+private:
+    static constexpr std::size_t kInitialChunkSize = 64 * 1024;
+
+    // Chunks come from upstream_, blocks are handed out and recycled by pool_
+    std::pmr::monotonic_buffer_resource upstream_;
+    std::pmr::unsynchronized_pool_resource pool_;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_NODE_ARENA_H
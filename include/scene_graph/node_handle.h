@@ -0,0 +1,86 @@
+#ifndef SCENE_GRAPH_NODE_HANDLE_H
+#define SCENE_GRAPH_NODE_HANDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace scene_graph {
+
+class Node;
+
+/**
+ * @brief A weak, non-owning reference to a Node: a registry slot index plus
+ * the generation of the node that occupied it.
+ *
+ * When a node is destroyed its slot's generation is bumped, so every handle
+ * to it stops resolving, even after the slot is reused. Copying and
+ * resolving a handle involves no reference counting.
+ */
+struct NodeHandle {
+    static constexpr std::uint32_t kInvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index = kInvalidIndex;
+    std::uint32_t generation = 0;
+
+    [[nodiscard]] bool isNull() const {
+        return index == kInvalidIndex;
+    }
+
+    bool operator==(const NodeHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const NodeHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Maps NodeHandles to live nodes.
+ *
+ * Every Node registers itself on construction and unregisters on
+ * destruction. Lookups and validity checks are a bounds check, an array
+ * access and a generation compare.
+ *
+ * The registry is not synchronized: nodes must be created and destroyed on
+ * one thread at a time, and not while other threads resolve handles.
+ * Concurrent lookups alone, e.g. during a parallel transform update, are
+ * safe.
+ */
+class NodeRegistry {
+public:
+    static NodeRegistry& instance();
+
+    NodeHandle add(Node* node);
+    void remove(NodeHandle handle);
+
+    [[nodiscard]] Node* get(NodeHandle handle) const {
+        if (handle.index >= slots_.size()) {
+            return nullptr;
+        }
+        const Slot& slot = slots_[handle.index];
+        return slot.generation == handle.generation ? slot.node : nullptr;
+    }
+    [[nodiscard]] bool isValid(NodeHandle handle) const {
+        return get(handle) != nullptr;
+    }
+
+    // Number of live nodes
+    [[nodiscard]] std::size_t size() const {
+        return slots_.size() - freeSlots_.size();
+    }
+
+private:
+    struct Slot {
+        Node* node = nullptr;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_NODE_HANDLE_H
@@ -9,6 +9,8 @@ class Rectangle : public Shape {
 public:
     static constexpr Vector2 DEFAULT_SIZE = Vector2(1.0F);
     Rectangle(const std::string& name, const Vector2& size = DEFAULT_SIZE);
+    Rectangle(std::allocator_arg_t, const Allocator& allocator, const std::string& name,
+              const Vector2& size = DEFAULT_SIZE);
     virtual ~Rectangle() = default;
 
     // Delete copy constructor and assignment operator
@@ -26,6 +28,7 @@ public:
     // Override virtual methods from Shape
     void render() const override;
     bool containsPoint(const Vector2& point) const override;
+    Aabb getLocalBounds() const override;
 
 private:
     Vector2 size_;
@@ -0,0 +1,82 @@
+#ifndef SCENE_GRAPH_ROTATION2_H
+#define SCENE_GRAPH_ROTATION2_H
+
+#include <cmath>
+
+#include "types.h"
+
+namespace scene_graph {
+
+/**
+ * @brief A 2D rotation stored as a unit complex number (cos, sin).
+ *
+ * Composing two rotations is a complex multiply and interpolating is a
+ * normalized lerp, so neither needs sin/cos/atan2. Angles only have to be
+ * converted with fromDegrees()/toDegrees() where they cross the public API.
+ */
+struct Rotation2 {
+    float cosine = 1.0F;
+    float sine = 0.0F;
+
+    static Rotation2 fromRadians(float angle) {
+        return {std::cos(angle), std::sin(angle)};
+    }
+
+    static Rotation2 fromDegrees(float angle) {
+        return fromRadians(radians(angle));
+    }
+
+    [[nodiscard]] float toRadians() const {
+        return std::atan2(sine, cosine);
+    }
+
+    /// Angle in degrees, in the range [0, 360)
+    [[nodiscard]] float toDegrees() const {
+        float angle = degrees(toRadians());
+        if (angle < 0.0F) {
+            angle += 360.0F;
+        }
+        return angle >= 360.0F ? 0.0F : angle;
+    }
+
+    /// Rotation by the opposite angle (the complex conjugate)
+    [[nodiscard]] Rotation2 inverse() const {
+        return {cosine, -sine};
+    }
+
+    /// Rescale to unit length, e.g. to undo drift after many compositions
+    [[nodiscard]] Rotation2 normalized() const {
+        const float length = std::sqrt(cosine * cosine + sine * sine);
+        if (length <= 0.0F) {
+            return {};
+        }
+        return {cosine / length, sine / length};
+    }
+
+    /**
+     * @brief Normalized linear interpolation between two rotations.
+     *
+     * Follows the shorter arc. Exactly opposite rotations have no unique
+     * midpoint; in that case the result turns counter-clockwise from start.
+     */
+    static Rotation2 nlerp(const Rotation2& start, const Rotation2& end, float factor) {
+        Rotation2 result{start.cosine + (end.cosine - start.cosine) * factor,
+                         start.sine + (end.sine - start.sine) * factor};
+
+        const float kMinLength = 1e-6F;
+        if (result.cosine * result.cosine + result.sine * result.sine < kMinLength) {
+            result = {-start.sine, start.cosine};
+        }
+        return result.normalized();
+    }
+};
+
+/// Compose two rotations; the angles add
+inline Rotation2 operator*(const Rotation2& lhs, const Rotation2& rhs) {
+    return {lhs.cosine * rhs.cosine - lhs.sine * rhs.sine,
+            lhs.sine * rhs.cosine + lhs.cosine * rhs.sine};
+}
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_ROTATION2_H
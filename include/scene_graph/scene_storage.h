@@ -0,0 +1,133 @@
+#ifndef SCENE_GRAPH_SCENE_STORAGE_H
+#define SCENE_GRAPH_SCENE_STORAGE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "scene_graph/affine2.h"
+#include "scene_graph/transform.h"
+#include "types.h"
+
+namespace scene_graph {
+
+class NodeView;
+
+/**
+ * @brief Data-oriented storage for the transforms of a whole hierarchy.
+ *
+ * Local and world transforms are kept in contiguous structure-of-arrays
+ * buffers, one slot per node, with every parent stored before its children.
+ * Propagating transforms over the hierarchy is then a single linear sweep
+ * that reads each parent's world matrix from an already updated slot,
+ * instead of chasing shared_ptr/weak_ptr links across the heap.
+ *
+ * This is an optional backend: Node and Transform remain the editing API,
+ * and a Node hierarchy can be flattened into a SceneStorage with fromNode().
+ */
+class SceneStorage {
+public:
+    using Slot = std::uint32_t;
+    static constexpr Slot kInvalidSlot = std::numeric_limits<Slot>::max();
+
+    SceneStorage() = default;
+
+    // Slot management
+    Slot add(Slot parent, const Transform& local = Transform());
+    void reserve(std::size_t capacity);
+    void clear();
+    [[nodiscard]] std::size_t size() const {
+        return parents_.size();
+    }
+
+    // Flatten a Node hierarchy in parent-before-child (pre-order) order
+    static SceneStorage fromNode(const Node& root);
+
+    // Propagate local transforms to world matrices in one linear sweep
+    void updateWorldTransforms();
+
+    // Per-slot accessors
+    [[nodiscard]] Slot getParent(Slot slot) const {
+        return parents_[slot];
+    }
+    void setPosition(Slot slot, const Vector2& position);
+    [[nodiscard]] Vector2 getPosition(Slot slot) const;
+    void setRotation(Slot slot, float rotation);
+    [[nodiscard]] float getRotation(Slot slot) const;
+    void setScale(Slot slot, const Vector2& scale);
+    [[nodiscard]] Vector2 getScale(Slot slot) const;
+    [[nodiscard]] const Affine2& getWorldMatrix(Slot slot) const {
+        return worldMatrices_[slot];
+    }
+
+    [[nodiscard]] NodeView view(Slot slot);
+
+private:
+    Slot addSubtree(const Node& node, Slot parent);
+
+    // Hierarchy
+    std::vector<Slot> parents_;
+
+    // Local transform components (rotation as a unit complex number)
+    std::vector<float> positionsX_;
+    std::vector<float> positionsY_;
+    std::vector<float> rotationsCos_;
+    std::vector<float> rotationsSin_;
+    std::vector<float> scalesX_;
+    std::vector<float> scalesY_;
+
+    // World transforms, valid after updateWorldTransforms()
+    std::vector<Affine2> worldMatrices_;
+};
+
+/**
+ * @brief A thin, non-owning view onto one slot of a SceneStorage.
+ *
+ * Mirrors the transform API of Node so code can address a node stored in
+ * the SoA backend without holding any per-node heap object.
+ */
+class NodeView {
+public:
+    NodeView(SceneStorage& storage, SceneStorage::Slot slot) : storage_(&storage), slot_(slot) {
+    }
+
+    [[nodiscard]] SceneStorage::Slot getSlot() const {
+        return slot_;
+    }
+    [[nodiscard]] bool hasParent() const {
+        return storage_->getParent(slot_) != SceneStorage::kInvalidSlot;
+    }
+    [[nodiscard]] NodeView getParent() const {
+        return {*storage_, storage_->getParent(slot_)};
+    }
+
+    void setPosition(const Vector2& position) {
+        storage_->setPosition(slot_, position);
+    }
+    [[nodiscard]] Vector2 getPosition() const {
+        return storage_->getPosition(slot_);
+    }
+    void setRotation(float rotation) {
+        storage_->setRotation(slot_, rotation);
+    }
+    [[nodiscard]] float getRotation() const {
+        return storage_->getRotation(slot_);
+    }
+    void setScale(const Vector2& scale) {
+        storage_->setScale(slot_, scale);
+    }
+    [[nodiscard]] Vector2 getScale() const {
+        return storage_->getScale(slot_);
+    }
+    [[nodiscard]] const Affine2& getWorldMatrix() const {
+        return storage_->getWorldMatrix(slot_);
+    }
+
+private:
+    SceneStorage* storage_;
+    SceneStorage::Slot slot_;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_SCENE_STORAGE_H
@@ -1,7 +1,8 @@
 #ifndef SCENE_GRAPH_SHAPE_H
 #define SCENE_GRAPH_SHAPE_H
 
-#include <string>
+#include <memory>
+#include <string_view>
 
 #include "scene_graph/node.h"
 #include "types.h"
@@ -10,7 +11,8 @@ namespace scene_graph {
 
 class Shape : public Node {
 public:
-    Shape(std::string name);
+    Shape(std::string_view name);
+    Shape(std::allocator_arg_t, const Allocator& allocator, std::string_view name);
     virtual ~Shape() = default;
 
     // Delete copy constructor and assignment operator
@@ -28,6 +30,9 @@ public:
     // Pure virtual methods to be implemented by derived classes
     virtual void render() const = 0;
     virtual bool containsPoint(const Vector2& point) const = 0;
+    // Unbounded by default, which keeps shapes that do not override it
+    // correct for culling and hit testing, just not accelerated
+    Aabb getLocalBounds() const override;
 
 private:
     Vector4 color_ = Vector4(1.0F, 1.0F, 1.0F, 1.0F);  // Default white
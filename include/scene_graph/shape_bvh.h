@@ -0,0 +1,78 @@
+#ifndef SCENE_GRAPH_SHAPE_BVH_H
+#define SCENE_GRAPH_SHAPE_BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "scene_graph/aabb.h"
+#include "types.h"
+
+namespace scene_graph {
+
+/**
+ * @brief A bounding volume hierarchy over the world-space bounds of shapes,
+ * for point queries such as hit testing.
+ *
+ * Shapes are given in priority order: when several shapes contain a point,
+ * the one given first wins. Every BVH node stores the best priority found in
+ * its subtree, so a query skips subtrees that cannot beat the best hit found
+ * so far and visits O(log n) nodes for a typical scene.
+ *
+ * When shapes move or resize but the set of shapes and their order stay the
+ * same, refit() updates the bounds without rebuilding the tree: only shapes
+ * whose bounds revision moved are re-read, and only their leaves and the
+ * ancestors of those are refit.
+ * The BVH holds raw pointers; rebuild it before any of its shapes dies.
+ */
+class ShapeBvh {
+public:
+    ShapeBvh() = default;
+
+    void build(const std::vector<Shape*>& shapesInPriorityOrder);
+    // Returns the number of shapes whose bounds were updated
+    std::size_t refit();
+    void clear();
+
+    // The highest-priority shape containing the point, or nullptr
+    [[nodiscard]] Shape* hitTest(const Vector2& point) const;
+
+    [[nodiscard]] std::size_t size() const {
+        return entries_.size();
+    }
+    [[nodiscard]] bool empty() const {
+        return entries_.empty();
+    }
+
+private:
+    static constexpr std::uint32_t kMaxLeafSize = 4;
+
+    struct Entry {
+        Aabb bounds;
+        Shape* shape;
+        std::uint32_t priority;
+        std::uint32_t boundsRevision;  // Of the shape when bounds was read
+        std::uint32_t leaf;            // Node holding the entry
+    };
+
+    // Inner nodes have count == 0; their left child directly follows them,
+    // so every child is stored after its parent
+    struct BvhNode {
+        Aabb bounds;
+        std::uint32_t minPriority;
+        std::uint32_t first;  // Leaves: first entry; inner nodes: right child
+        std::uint32_t count;
+    };
+
+    std::uint32_t buildRange(std::uint32_t first, std::uint32_t count, std::uint32_t parent);
+    void refitNode(std::uint32_t index);
+
+    std::vector<Entry> entries_;
+    std::vector<BvhNode> nodes_;
+    // Kept apart from nodes_, which queries walk, as only refit() needs it
+    std::vector<std::uint32_t> parents_;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_SHAPE_BVH_H
@@ -0,0 +1,90 @@
+#ifndef SCENE_GRAPH_TASK_SCHEDULER_H
+#define SCENE_GRAPH_TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scene_graph {
+
+/**
+ * @brief A small work-stealing thread pool.
+ *
+ * Every participating thread owns a task queue. A thread pushes and pops
+ * its own tasks at the back (most recently submitted first, which keeps
+ * recursively split work cache-warm) and, when its queue runs dry, steals
+ * the oldest task from the front of another thread's queue.
+ *
+ * Queue 0 belongs to whichever outside thread calls wait(); that thread
+ * runs tasks too instead of blocking, so a scheduler with a thread count of
+ * one runs everything on the calling thread.
+ *
+ * Tasks may submit further tasks. wait() returns once every task submitted
+ * so far, including nested ones, has finished. A task must not call wait()
+ * itself: it would wait for its own completion. That is a programming
+ * error; wait() then throws std::logic_error, which fails the task and is
+ * rethrown by the outer wait().
+ *
+ * A task that throws still counts as finished. The first exception thrown
+ * since the last wait() is rethrown from wait() once all tasks are done.
+ */
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    // A thread count of 0 uses one thread per hardware thread
+    explicit TaskScheduler(std::size_t threadCount = 0);
+    ~TaskScheduler();
+
+    // delete copy and move constructors and assignment operators
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    TaskScheduler(TaskScheduler&&) = delete;
+    TaskScheduler& operator=(TaskScheduler&&) = delete;
+
+    // Number of threads that run tasks, including the waiting thread
+    [[nodiscard]] std::size_t getThreadCount() const {
+        return queues_.size();
+    }
+
+    void submit(Task task);
+    void wait();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+    bool runOne(std::size_t index);
+    bool popLocal(std::size_t index, Task& task);
+    bool steal(std::size_t thief, Task& task);
+    [[nodiscard]] std::size_t currentQueueIndex() const;
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // Submitted but not yet finished / not yet started
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> queued_{0};
+
+    // First exception a task threw, rethrown by wait()
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+    bool stopping_ = false;
+};
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_TASK_SCHEDULER_H
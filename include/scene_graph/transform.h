@@ -1,6 +1,8 @@
 #ifndef SCENE_GRAPH_TRANSFORM_H
 #define SCENE_GRAPH_TRANSFORM_H
 
+#include "scene_graph/affine2.h"
+#include "scene_graph/rotation2.h"
 #include "types.h"
 
 namespace scene_graph {
@@ -12,6 +14,17 @@ namespace scene_graph {
  * scale of an object in 2D space. It also provides methods for combining and
  * interpolating transforms, as well as converting between local and global
  * coordinates.
+ *
+ * The matrix is kept as a compact 2D affine (Affine2); a 4x4 Matrix4 is only
+ * built on request by getMatrix(), e.g. when uploading to the GPU.
+ *
+ * Transforms built from a matrix (setMatrix(), setAffine(), combine(),
+ * inverse()) only store the matrix. Position, rotation and scale are
+ * decomposed from it lazily, the first time one of them is read or set.
+ *
+ * Rotation is stored as a unit complex number (Rotation2), so rotating,
+ * composing and interpolating need no trig. Degrees are only converted in
+ * setRotation() and getRotation().
  */
 class Transform {
 public:
@@ -24,30 +37,47 @@ public:
     // delete move assignment operator
     Transform& operator=(Transform&&) = default;
 
-    [[nodiscard]] const Matrix4& getMatrix() const {
+    [[nodiscard]] const Affine2& getAffine() const {
         return matrix_;
     }
+    [[nodiscard]] Matrix4 getMatrix() const {
+        return matrix_.toMatrix4();
+    }
 
     void setScale(const Vector2& scale) {
+        ensureDecomposed();
         scale_ = scale;
         updateMatrix();
     }
 
+    // The translation is stored in the matrix as is
     void setPosition(const Vector2& position) {
-        position_ = position;
-        updateMatrix();
+        matrix_.tx = position.x;
+        matrix_.ty = position.y;
     }
     void setRotation(float rotation);
+    void setRotation(const Rotation2& rotation);
+    void rotateBy(const Rotation2& delta);
 
     void setMatrix(const Matrix4& matrix);
+    void setAffine(const Affine2& matrix);
 
     [[nodiscard]] const Vector2& getScale() const {
+        ensureDecomposed();
         return scale_;
     }
-    // float getRotation() const { return degrees(rotation_); }
     [[nodiscard]] float getRotation() const;
-    [[nodiscard]] const Vector2& getPosition() const {
-        return position_;
+    [[nodiscard]] const Rotation2& getRotation2() const {
+        ensureDecomposed();
+        return rotation_;
+    }
+    [[nodiscard]] Vector2 getPosition() const {
+        return {matrix_.tx, matrix_.ty};
+    }
+
+    // True once position, rotation and scale are in sync with the matrix
+    [[nodiscard]] bool isDecomposed() const {
+        return decomposed_;
     }
 
     [[nodiscard]] Transform inverse() const;
@@ -64,10 +94,23 @@ public:
 
 private:
     void updateMatrix();
-    Vector2 position_;
-    float rotation_;
-    Vector2 scale_;
-    Matrix4 matrix_;
+    void ensureDecomposed() const {
+        if (!decomposed_) {
+            decompose();
+        }
+    }
+    void decompose() const;
+
+    // Rotation and scale are derived from matrix_ on demand when decomposed_
+    // is false; the position always lives in the matrix translation
+    mutable Rotation2 rotation_;
+    mutable Vector2 scale_;
+    Affine2 matrix_;
+
+    // Degrees last passed to setRotation(), or derived by getRotation()
+    mutable float rotationDegrees_ = 0.0F;
+    mutable bool rotationDegreesValid_ = true;
+    mutable bool decomposed_ = true;
 };
 
 }  // namespace scene_graph
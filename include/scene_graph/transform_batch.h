@@ -0,0 +1,103 @@
+#ifndef SCENE_GRAPH_TRANSFORM_BATCH_H
+#define SCENE_GRAPH_TRANSFORM_BATCH_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "scene_graph/affine2.h"
+#include "types.h"
+
+namespace scene_graph {
+
+class TaskScheduler;
+
+/// Instruction sets the batch kernels can run on
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+/**
+ * @brief A batch of affine transforms in structure-of-arrays layout.
+ *
+ * One array per matrix element, so a SIMD register can hold the same element
+ * of several transforms and a batch composes with plain vertical arithmetic.
+ */
+struct AffineBatch {
+    std::vector<float> a;
+    std::vector<float> b;
+    std::vector<float> c;
+    std::vector<float> d;
+    std::vector<float> tx;
+    std::vector<float> ty;
+
+    [[nodiscard]] std::size_t size() const {
+        return a.size();
+    }
+    void clear();
+    void resize(std::size_t count);
+    void set(std::size_t index, const Affine2& matrix);
+    void push_back(const Affine2& matrix);
+    [[nodiscard]] Affine2 get(std::size_t index) const;
+};
+
+// Runtime dispatch
+[[nodiscard]] SimdLevel getBestSimdLevel();
+[[nodiscard]] bool isSimdLevelSupported(SimdLevel level);
+
+/**
+ * @brief Compose out[i] = parents[i] * locals[i] for a whole batch.
+ *
+ * Every SIMD level performs the same multiplies and adds in the same order
+ * as the scalar operator*(Affine2, Affine2), so results are bit-identical
+ * whichever level runs. Unsupported levels fall back to the scalar path.
+ */
+void composeAffineBatch(const AffineBatch& parents, const AffineBatch& locals, AffineBatch& out,
+                        SimdLevel level = getBestSimdLevel());
+
+/**
+ * @brief Propagates world transforms through a Node hierarchy in batches.
+ *
+ * Walks the hierarchy one level at a time, gathers every node whose cached
+ * world transform is dirty, composes the whole level with
+ * composeAffineBatch() and stores the results back into the nodes' caches.
+ * Afterwards getGlobalMatrix() is a cache hit for every node in the tree.
+ *
+ * The buffers are kept between calls, so a long-lived updater does not
+ * allocate in the steady state.
+ */
+class WorldTransformUpdater {
+public:
+    void update(Node& root);
+    void update(const std::vector<Node*>& roots);
+
+private:
+    // Nodes composed per kernel call; small enough to stay in L1
+    static constexpr std::size_t kChunkSize = 256;
+
+    void updateLevels();
+    void flush(std::size_t count);
+
+    std::vector<Node*> level_;
+    std::vector<Node*> nextLevel_;
+    std::array<Node*, kChunkSize> dirtyNodes_{};
+    AffineBatch parents_;
+    AffineBatch locals_;
+    AffineBatch worlds_;
+};
+
+// Convenience wrapper using a temporary updater
+void updateWorldTransforms(Node& root);
+
+/**
+ * @brief Parallel updateWorldTransforms() for wide hierarchies.
+ *
+ * Splits the hierarchy at subtree boundaries using the cached subtree
+ * sizes: subtrees larger than the grain size are split further in their own
+ * task, smaller sibling subtrees are grouped until a group reaches the grain
+ * size. Each task updates its group of subtrees together with a per-thread
+ * WorldTransformUpdater. Blocks until the whole tree is up to date.
+ */
+void updateWorldTransforms(Node& root, TaskScheduler& scheduler);
+
+}  // namespace scene_graph
+
+#endif  // SCENE_GRAPH_TRANSFORM_BATCH_H
@@ -1,14 +1,35 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "scene_graph/aabb.h"
 #include "scene_graph/node.h"
 #include "scene_graph/shape.h"
+#include "scene_graph/shape_bvh.h"
+#include "scene_graph/transform_batch.h"
 #include "types.h"
 #include "visualization/renderer.h"
+#include "visualization/shape_batch.h"
+
+namespace scene_graph {
+class TaskScheduler;
+}
 
 namespace visualization {
+
+/**
+ * @brief What the last Canvas::render() call drew and what it culled.
+ */
+struct RenderStats {
+    std::size_t drawn = 0;           // Shapes drawn
+    std::size_t culled = 0;          // Out-of-view nodes, counting all nodes of culled subtrees
+    std::size_t culledSubtrees = 0;  // Subtrees skipped with a single bounds test
+};
+
 /**
  * @brief The Canvas class is responsible for rendering the scene graph.
  *
@@ -31,6 +52,12 @@ public:
     // Initialize the canvas with a renderer
     bool initialize(const std::shared_ptr<Renderer>& renderer);
 
+    // Record the scene graph on the scheduler's threads; without one, or
+    // with a single thread, it is recorded on the calling thread
+    void setTaskScheduler(std::shared_ptr<scene_graph::TaskScheduler> scheduler) {
+        scheduler_ = std::move(scheduler);
+    }
+
     // Set the root node of the canvas
     void setRoot(const std::shared_ptr<scene_graph::Node>& root);
     std::shared_ptr<scene_graph::Node> getRoot() const;
@@ -42,18 +69,62 @@ public:
     // Canvas methods
     void render();
     void clear();
+    // Gathers the visible shapes of a subtree; render() draws them
     void renderNode(const std::shared_ptr<scene_graph::Node>& node);
     [[nodiscard]] std::shared_ptr<scene_graph::Node> hitTest(const Vector2& position) const;
     void selectNode(const std::shared_ptr<scene_graph::Node>& node);
     [[nodiscard]] std::shared_ptr<scene_graph::Node> getSelectedNode() const;
+    [[nodiscard]] const RenderStats& getRenderStats() const {
+        return renderStats_;
+    }
+    // The shapes of the last frame, in draw order
+    [[nodiscard]] const ShapeBatch& getShapeBatch() const {
+        return shapeBatch_;
+    }
+    // Hit test of a subtree by traversal, without the BVH; skips subtrees
+    // whose bounds miss the position
     [[nodiscard]] std::shared_ptr<scene_graph::Node> hitTestRecursive(
         const std::shared_ptr<scene_graph::Node>& node, const Vector2& position) const;
 
 private:
+    // A contiguous run of the root's children, recorded by one task
+    struct RecordChunk {
+        std::vector<scene_graph::Node*> roots;
+        ShapeBatch batch;
+        RenderStats stats;
+    };
+
+    void recordParallel(scene_graph::Node& root);
+    void gatherNode(const scene_graph::Node& node, ShapeBatch& batch, RenderStats& stats) const;
+    void gatherShape(const scene_graph::Node& node, ShapeBatch& batch, RenderStats& stats) const;
+    void updateHitTestBvh() const;
+    static void collectHitOrder(scene_graph::Node& node,
+                                std::vector<scene_graph::Shape*>& shapes);
+
     std::shared_ptr<Renderer> renderer_;
     std::shared_ptr<scene_graph::Node> root_;
     std::shared_ptr<scene_graph::Node> selectedNode_;
     std::vector<std::shared_ptr<scene_graph::Shape>> shapes_;
+
+    // Reused every frame to propagate world transforms
+    scene_graph::WorldTransformUpdater transformUpdater_;
+
+    // Visible region of the frame being rendered, for culling
+    scene_graph::Aabb viewBounds_ = scene_graph::Aabb::infinite();
+    RenderStats renderStats_;
+
+    // Shapes gathered for the frame being rendered, reused every frame
+    ShapeBatch shapeBatch_;
+
+    // Parallel recording; the chunks keep their buffers between frames
+    std::shared_ptr<scene_graph::TaskScheduler> scheduler_;
+    std::vector<RecordChunk> recordChunks_;
+
+    // Hit test acceleration, brought up to date lazily by hitTest()
+    mutable scene_graph::ShapeBvh hitTestBvh_;
+    mutable bool hitTestBvhStale_ = true;
+    mutable std::uint64_t hitTestBoundsRevision_ = 0;
+    mutable std::uint64_t hitTestHierarchyRevision_ = 0;
 };
 
 }  // namespace visualization
@@ -0,0 +1,27 @@
+// visualization/distance_field.h
+#ifndef VISUALIZATION_DISTANCE_FIELD_H
+#define VISUALIZATION_DISTANCE_FIELD_H
+
+#include <vector>
+
+namespace visualization {
+
+// Value of the outline in a distance field
+inline constexpr unsigned char kDistanceFieldEdge = 128;
+
+// A single-channel signed distance field, one byte per pixel
+struct DistanceField {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Build a field from a coverage bitmap, padded by spread pixels on each
+// side. Values rise inside the outline and fall outside it, saturating
+// spread pixels away
+DistanceField makeDistanceField(const unsigned char* coverage, int width, int height, int pitch,
+                                int spread);
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_DISTANCE_FIELD_H
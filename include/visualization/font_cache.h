@@ -0,0 +1,96 @@
+// visualization/font_cache.h
+#ifndef VISUALIZATION_FONT_CACHE_H
+#define VISUALIZATION_FONT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "glyph_atlas.h"
+
+namespace visualization {
+
+// The font a cache was built from; a cache is only used for the same key
+struct FontCacheKey {
+    std::string fontPath;
+    std::int64_t modifiedTime = 0;  // Of the font file, in file clock ticks
+    int pixelSize = 0;
+    bool distanceField = false;  // Glyphs stored as distance fields
+};
+
+// A rasterized glyph as stored in a cache file
+struct CachedGlyph {
+    std::uint32_t codePoint;
+    std::int32_t width;
+    std::int32_t height;
+    std::int32_t bearingX;
+    std::int32_t bearingY;
+    std::uint32_t advance;  // 26.6 fixed point, as FreeType reports it
+    std::int32_t atlasX;
+    std::int32_t atlasY;
+};
+
+// The key for a font file as it is now; nothing if it does not exist
+std::optional<FontCacheKey> makeFontCacheKey(const std::string& fontPath, int pixelSize);
+
+// Where the cache for a font lives in the user's cache directory; empty if
+// there is no cache directory
+std::string getFontCachePath(const FontCacheKey& key);
+
+// Write an atlas and the glyphs in it, replacing any older cache atomically
+bool writeFontCache(const std::string& path, const FontCacheKey& key, const GlyphAtlas& atlas,
+                    const std::vector<CachedGlyph>& glyphs);
+
+/**
+ * @brief A font cache file mapped read-only into memory.
+ *
+ * The file holds a header with the key and the atlas's packing state, the
+ * glyph metrics and then the atlas pixels, which are read straight from the
+ * mapping.
+ */
+class FontCacheFile {
+public:
+    // Nothing if the file is missing, belongs to another key or is damaged
+    static std::unique_ptr<FontCacheFile> open(const std::string& path, const FontCacheKey& key);
+    ~FontCacheFile();
+
+    // Delete copy and move operations
+    FontCacheFile(const FontCacheFile&) = delete;
+    FontCacheFile& operator=(const FontCacheFile&) = delete;
+    FontCacheFile(FontCacheFile&&) = delete;
+    FontCacheFile& operator=(FontCacheFile&&) = delete;
+
+    [[nodiscard]] int getAtlasWidth() const {
+        return atlasWidth_;
+    }
+    [[nodiscard]] const GlyphAtlas::PackState& getPackState() const {
+        return packState_;
+    }
+    [[nodiscard]] const std::vector<CachedGlyph>& getGlyphs() const {
+        return glyphs_;
+    }
+    // getAtlasWidth() * getPackState().height bytes
+    [[nodiscard]] const unsigned char* getPixels() const {
+        return pixels_;
+    }
+
+private:
+    FontCacheFile() = default;
+
+    void* mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    // The file's contents where it cannot be mapped
+    std::vector<unsigned char> contents_;
+
+    int atlasWidth_ = 0;
+    GlyphAtlas::PackState packState_{};
+    std::vector<CachedGlyph> glyphs_;
+    const unsigned char* pixels_ = nullptr;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_FONT_CACHE_H
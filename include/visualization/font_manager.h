@@ -4,14 +4,17 @@
 
 #include <ft2build.h>
 
+#include "glyph_atlas.h"
 #include "render_types.h"
 #include FT_FREETYPE_H
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <string>
 
 namespace visualization {
 
+struct FontCacheKey;
+
 class FontManager {
 public:
     FontManager();
@@ -23,24 +26,48 @@ public:
     FontManager(FontManager&&) = delete;
     FontManager& operator=(FontManager&&) = delete;
 
-    // Initialization
+    // Initialization; the glyph mode is set before initialize() and
+    // ignored after it
+    void setGlyphMode(GlyphMode mode);
+    GlyphMode getGlyphMode() const;
     bool initialize(RenderMode mode = RenderMode::Normal);
     void cleanup();
 
-    // Font loading
+    // Font loading; the face stays open and each glyph is rasterized the
+    // first time it is asked for
     bool loadSystemFonts();
     void createFallbackFont();
 
-    // Character retrieval
-    const Character* getCharacter(char c) const;
-    bool hasCharacter(char c) const;
+    // Character retrieval by Unicode code point
+    const Character* getCharacter(char32_t codePoint);
+    bool hasCharacter(char32_t codePoint);
+    // Glyphs rasterized so far
+    std::size_t getGlyphCount() const;
+    // Glyph metrics are in atlas pixels; this converts them to font size pixels
+    float getGlyphScale() const;
+
+    // All glyphs live in one atlas texture, which grows as glyphs are added
+    unsigned int getAtlasTexture() const;
+    const GlyphAtlas& getAtlas() const;
+    // Upload glyphs added since the last call; binds the atlas texture to
+    // the active texture unit if anything changed
+    void syncAtlasTexture();
 
     // Information
     bool isInitialized() const;
 
 private:
-    // Platform-specific font loading
-    bool loadFonts(FT_Library ft, FT_Face& face);
+    // Open a font file with FreeType at the font size
+    bool openFace(const std::string& path);
+    // The atlas cache lets later runs skip FreeType for glyphs drawn before
+    bool loadAtlasCache(const FontCacheKey& key);
+    void saveAtlasCache();
+
+    // Rasterize a glyph of the open face into the atlas
+    bool loadGlyph(char32_t codePoint, Character& character);
+    // Store a glyph's bitmap in the atlas and return its metrics
+    bool addGlyph(int width, int height, const unsigned char* pixels, int pitch,
+                  const glm::ivec2& bearing, unsigned int advance, Character& character);
 
     // Implementation details
     struct Impl;
@@ -0,0 +1,86 @@
+// visualization/glyph_atlas.h
+#ifndef VISUALIZATION_GLYPH_ATLAS_H
+#define VISUALIZATION_GLYPH_ATLAS_H
+
+#include <optional>
+#include <vector>
+
+namespace visualization {
+
+// A rectangle of an atlas, in pixels from its top-left corner
+struct AtlasRegion {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/**
+ * @brief Packs glyph bitmaps into one single-channel image, to be uploaded
+ * as one texture.
+ *
+ * Bitmaps are placed left to right on shelves as tall as the tallest bitmap
+ * on them, with a border of empty pixels around each so linear filtering
+ * does not bleed between neighbours. Row 0 is the top of the image and is
+ * uploaded first, so it ends up at texture coordinate v = 0.
+ *
+ * When the shelves run out the image doubles in height, up to maxHeight.
+ * New rows go below the old ones, so regions handed out keep their pixel
+ * coordinates; only coordinates normalized by the height change.
+ */
+class GlyphAtlas {
+public:
+    static constexpr int kPadding = 1;
+
+    // Where packing has got to, for saving an atlas and restoring it later
+    struct PackState {
+        int height;
+        int shelfX;
+        int shelfY;
+        int shelfHeight;
+    };
+
+    // maxHeight defaults to height, for an atlas that never grows
+    GlyphAtlas(int width, int height, int maxHeight = 0);
+
+    // Copy a bitmap in, growing if needed; nothing if it does not fit. An
+    // empty bitmap gets an empty region without using space
+    std::optional<AtlasRegion> insert(int width, int height, const unsigned char* pixels,
+                                      int pitch);
+    // Empty the atlas and shrink it back to its initial height
+    void clear();
+
+    [[nodiscard]] PackState getPackState() const {
+        return {height_, shelfX_, shelfY_, shelfHeight_};
+    }
+    // Replace the contents with a saved atlas of the same width, whose
+    // pixels are width * state.height bytes; false if it does not fit or
+    // its shelf lies outside it
+    bool restore(const PackState& state, const unsigned char* pixels);
+
+    [[nodiscard]] int getWidth() const {
+        return width_;
+    }
+    [[nodiscard]] int getHeight() const {
+        return height_;
+    }
+    [[nodiscard]] const std::vector<unsigned char>& getPixels() const {
+        return pixels_;
+    }
+
+private:
+    int width_;
+    int height_;
+    int initialHeight_;
+    int maxHeight_;
+    std::vector<unsigned char> pixels_;
+
+    // The open shelf and the next free pixel on it
+    int shelfX_ = kPadding;
+    int shelfY_ = kPadding;
+    int shelfHeight_ = 0;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_GLYPH_ATLAS_H
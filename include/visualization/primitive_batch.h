@@ -0,0 +1,56 @@
+// visualization/primitive_batch.h
+#ifndef VISUALIZATION_PRIMITIVE_BATCH_H
+#define VISUALIZATION_PRIMITIVE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "types.h"
+
+namespace visualization {
+
+// A vertex of a flat colored primitive, in world coordinates
+struct PrimitiveVertex {
+    float x;
+    float y;
+    float r;
+    float g;
+    float b;
+    float a;
+};
+
+/**
+ * @brief Colored quads accumulated on the CPU until they are drawn together.
+ *
+ * Rectangles and lines are both expanded to two triangles with the color
+ * baked into every vertex, so any mix of them can be drawn with one call in
+ * the order they were added.
+ */
+class PrimitiveBatch {
+public:
+    static constexpr std::size_t kVerticesPerQuad = 6;
+
+    void addRectangle(float x, float y, float width, float height, const Vector4& color);
+    void addLine(float x1, float y1, float x2, float y2, const Vector4& color, float thickness);
+    void clear();
+
+    [[nodiscard]] const std::vector<PrimitiveVertex>& getVertices() const {
+        return vertices_;
+    }
+    [[nodiscard]] std::size_t getQuadCount() const {
+        return vertices_.size() / kVerticesPerQuad;
+    }
+    [[nodiscard]] bool empty() const {
+        return vertices_.empty();
+    }
+
+private:
+    void addQuad(const Vector2& p0, const Vector2& p1, const Vector2& p2, const Vector2& p3,
+                 const Vector4& color);
+
+    std::vector<PrimitiveVertex> vertices_;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_PRIMITIVE_BATCH_H
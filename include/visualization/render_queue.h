@@ -0,0 +1,140 @@
+// visualization/render_queue.h
+#ifndef VISUALIZATION_RENDER_QUEUE_H
+#define VISUALIZATION_RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "primitive_batch.h"
+#include "shape_batch.h"
+#include "types.h"
+
+namespace visualization {
+
+// Draw layers, drawn in this order whatever order they were recorded in
+enum class RenderLayer : std::uint8_t { Scene, Overlay };
+
+// What a command draws, and so which program and vertex array it uses
+enum class RenderCommandType : std::uint8_t { Shapes, Primitives, Text };
+
+/**
+ * @brief 64-bit render command sort keys.
+ *
+ * From the most significant bit: the layer (4 bits), the shape batch (12),
+ * a translucent flag, then for opaque commands the shader (8), the vertex
+ * array (8) and the depth (24); translucent commands move the depth in
+ * front of the shader and vertex array, so they keep their order and only
+ * tie-break on state. Opaque shapes of one batch are depth tested and may
+ * be drawn in any order, so sorting them groups draws by state instead.
+ *
+ * The batch counts the shape batches recorded so far: each batch and the
+ * primitives and text recorded after it draw before the next batch, so
+ * later shapes cover earlier lines and text. Past kMaxBatch batches share
+ * the last value, and their opaque shapes may draw out of order.
+ */
+namespace sort_key {
+
+inline constexpr std::uint32_t kMaxBatch = (1U << 12) - 1;
+inline constexpr std::uint32_t kMaxDepth = (1U << 24) - 1;
+
+std::uint64_t make(RenderLayer layer, std::uint32_t batch, bool translucent, std::uint8_t shader,
+                   std::uint8_t vertexArray, std::uint32_t depth);
+
+RenderLayer layer(std::uint64_t key);
+std::uint32_t batch(std::uint64_t key);
+bool isTranslucent(std::uint64_t key);
+std::uint8_t shader(std::uint64_t key);
+std::uint8_t vertexArray(std::uint64_t key);
+std::uint32_t depth(std::uint64_t key);
+
+}  // namespace sort_key
+
+// One draw; its data lives in the queue that recorded it
+struct RenderCommand {
+    std::uint64_t key = 0;
+    RenderCommandType type = RenderCommandType::Shapes;
+    ShapeKind kind = ShapeKind::Rectangle;  // Shapes only
+    std::uint32_t first = 0;  // First instance, primitive quad or text run
+    std::uint32_t count = 0;  // Instances, quads or text runs
+};
+
+// A string drawn by a Text command, stored in the queue's text buffer
+struct TextRun {
+    std::uint32_t offset;
+    std::uint32_t length;
+    float x;
+    float y;
+    Vector4 color;
+};
+
+/**
+ * @brief Draws recorded for one submission, with the data they draw,
+ * sorted before they are executed.
+ *
+ * Recording only touches memory, so a queue can be filled and inspected
+ * without a GL context. Consecutive rectangles and lines of one layer
+ * share a command, as do consecutive strings. Primitives and text are
+ * translucent: they are drawn in the order recorded, as 2D overlays rely
+ * on, and never before a shape batch recorded ahead of them. sort() is
+ * stable, so commands with equal keys also keep their recorded order.
+ */
+class RenderQueue {
+public:
+    void clear();
+
+    // Record the ranges of a built batch; opaque ranges are sorted by state
+    // within the batch
+    void addShapes(const ShapeBatch& batch, RenderLayer layer);
+    void addRectangle(RenderLayer layer, float x, float y, float width, float height,
+                      const Vector4& color);
+    void addLine(RenderLayer layer, float x1, float y1, float x2, float y2, const Vector4& color,
+                 float thickness);
+    void addText(RenderLayer layer, std::string_view text, float x, float y,
+                 const Vector4& color);
+
+    void sort();
+
+    [[nodiscard]] const std::vector<RenderCommand>& getCommands() const {
+        return commands_;
+    }
+    [[nodiscard]] const std::vector<ShapeInstance>& getInstances() const {
+        return instances_;
+    }
+    [[nodiscard]] const PrimitiveBatch& getPrimitives() const {
+        return primitives_;
+    }
+    [[nodiscard]] const TextRun& getTextRun(std::uint32_t index) const {
+        return textRuns_[index];
+    }
+    [[nodiscard]] std::string_view getText(const TextRun& run) const {
+        return std::string_view(text_).substr(run.offset, run.length);
+    }
+    [[nodiscard]] std::size_t size() const {
+        return commands_.size();
+    }
+    [[nodiscard]] bool empty() const {
+        return commands_.empty();
+    }
+
+private:
+    // Extend the last command with the quads just added, or start one
+    void recordPrimitives(RenderLayer layer, std::size_t quadsBefore);
+    // Translucent commands are ordered by when they were recorded
+    std::uint32_t nextDepth();
+
+    std::vector<RenderCommand> commands_;
+    std::vector<ShapeInstance> instances_;
+    PrimitiveBatch primitives_;
+    std::vector<TextRun> textRuns_;
+    std::string text_;
+    std::uint32_t sequence_ = 0;
+    // Shape batches recorded so far
+    std::uint32_t batch_ = 0;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_RENDER_QUEUE_H
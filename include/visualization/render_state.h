@@ -0,0 +1,101 @@
+// visualization/render_state.h
+#ifndef VISUALIZATION_RENDER_STATE_H
+#define VISUALIZATION_RENDER_STATE_H
+
+#include <cstddef>
+#include <limits>
+
+namespace visualization {
+
+// How many state changes reached GL and how many were dropped as redundant
+struct RenderStateStats {
+    std::size_t issued = 0;
+    std::size_t skipped = 0;
+};
+
+/**
+ * @brief Shadows the GL state the renderers change and drops changes that
+ * would not change anything.
+ *
+ * Tracks the program, vertex array, array buffer, active texture unit and
+ * the 2D texture bound to each unit, and the blend and depth test settings.
+ * The element array buffer is part of the vertex array and is not tracked.
+ * Until a value is first set, or after invalidate(), its GL state is
+ * unknown and the next change always reaches GL.
+ *
+ * All GL state changes made while drawing must go through this class, or
+ * the shadow goes stale; code that binds objects directly, such as resource
+ * setup, calls invalidate() afterwards. Objects deleted while bound must be
+ * reported so a recycled name is not mistaken for a bound one. In headless
+ * mode nothing reaches GL, but the tracking and the statistics still work.
+ */
+class RenderState {
+public:
+    static constexpr std::size_t kMaxTextureUnits = 8;
+
+    RenderState() = default;
+
+    // delete copy and move constructors and assignment operators
+    RenderState(const RenderState&) = delete;
+    RenderState& operator=(const RenderState&) = delete;
+    RenderState(RenderState&&) = delete;
+    RenderState& operator=(RenderState&&) = delete;
+
+    void setHeadless(bool headless) {
+        headless_ = headless;
+    }
+
+    // Binding; GLenum parameters are passed as unsigned int
+    void useProgram(unsigned int program);
+    void bindVertexArray(unsigned int vertexArray);
+    void bindArrayBuffer(unsigned int buffer);
+    void activeTexture(unsigned int unit);  // Unit index, not GL_TEXTURE0 + unit
+    void bindTexture2D(unsigned int texture);
+
+    // Fixed-function state
+    void setBlend(bool enabled);
+    void setBlendFunc(unsigned int sourceFactor, unsigned int destinationFactor);
+    void setDepthTest(bool enabled);
+    void setDepthFunc(unsigned int func);
+
+    // Deleting a bound object unbinds it in GL
+    void onProgramDeleted(unsigned int program);
+    void onVertexArrayDeleted(unsigned int vertexArray);
+    void onBufferDeleted(unsigned int buffer);
+    void onTextureDeleted(unsigned int texture);
+
+    // Forget everything; the next change of each kind reaches GL
+    void invalidate();
+
+    [[nodiscard]] const RenderStateStats& getStats() const {
+        return stats_;
+    }
+    void resetStats() {
+        stats_ = RenderStateStats();
+    }
+
+private:
+    static constexpr unsigned int kUnknown = std::numeric_limits<unsigned int>::max();
+
+    // Record a change; true if it must reach GL
+    bool change(unsigned int& shadow, unsigned int value);
+
+    bool headless_ = false;
+    RenderStateStats stats_;
+
+    unsigned int program_ = kUnknown;
+    unsigned int vertexArray_ = kUnknown;
+    unsigned int arrayBuffer_ = kUnknown;
+    unsigned int activeUnit_ = kUnknown;
+    unsigned int textures_[kMaxTextureUnits] = {kUnknown, kUnknown, kUnknown, kUnknown,
+                                                kUnknown, kUnknown, kUnknown, kUnknown};
+    unsigned int blend_ = kUnknown;
+    unsigned int blendSource_ = kUnknown;
+    unsigned int blendDestination_ = kUnknown;
+    unsigned int depthTest_ = kUnknown;
+    unsigned int depthFunc_ = kUnknown;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_RENDER_STATE_H
@@ -4,19 +4,46 @@
 
 #include <glm/glm.hpp>
 
+#include "types.h"
+
 namespace visualization {
 
 // Character glyph data for font rendering
 struct Character {
-    unsigned int textureID;  // ID handle of the glyph texture
+    unsigned int textureID;  // ID handle of the atlas texture holding the glyph
     glm::ivec2 size;         // Size of glyph
     glm::ivec2 bearing;      // Offset from baseline to left/top of glyph
     unsigned int advance;    // Offset to advance to next glyph
+    glm::vec2 atlasMin;      // Atlas pixel coordinates of the glyph's top left
+    glm::vec2 atlasMax;      // and bottom right; the shader normalizes them
 };
 
 // Rendering modes
 enum class RenderMode { Normal, Headless };
 
+// How glyphs are stored in the atlas: coverage bitmaps, sharp at the font
+// size only, or signed distance fields, sharp at any scale
+enum class GlyphMode { Bitmap, DistanceField };
+
+// Per-frame camera data, shared by all programs through the std140 uniform
+// block below; Renderer fills it once per frame
+struct CameraUniforms {
+    Matrix4 projection;      // World space, follows the viewport
+    Matrix4 textProjection;  // Fixed scene space used for text
+};
+
+inline constexpr const char* kCameraBlockName = "Camera";
+inline constexpr unsigned int kCameraBindingPoint = 0;
+
+// GLSL declaration of the camera block, for vertex shaders to include after
+// their #version line; its layout matches CameraUniforms
+inline constexpr const char* kCameraBlockGlsl = R"(
+        layout (std140) uniform Camera {
+            mat4 projection;
+            mat4 textProjection;
+        };
+)";
+
 // Dummy function to ensure render_types.cpp produces symbols
 bool initializeRenderTypes();
 
@@ -4,9 +4,14 @@
 #include <scene_graph/shape.h>
 
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "constants.h"
 #include "font_manager.h"
+#include "render_queue.h"
+#include "render_state.h"
 #include "render_types.h"
 #include "shader_manager.h"
 #include "shape_renderer.h"
@@ -31,35 +36,86 @@ public:
     // Headless mode for testing
     void setHeadlessMode(bool headless);
     bool isHeadlessMode() const;
+    // How text glyphs are rasterized; set before initialize(), ignored after
+    void setGlyphMode(GlyphMode mode);
 
     // Frame management
     void beginFrame();
     void endFrame();
+    // Sort the recorded commands and execute them
+    void flush();
     void setViewport(int width, int height);
-
-    // Shape rendering (delegated to ShapeRenderer)
-    void renderShape(const scene_graph::Shape& shape);
+    // World-space region visible through the shape projection
+    scene_graph::Aabb getViewBounds() const;
+
+    // Layer the following draws are recorded in; beginFrame() resets it to
+    // RenderLayer::Scene
+    void setLayer(RenderLayer layer) {
+        layer_ = layer;
+    }
+    RenderLayer getLayer() const {
+        return layer_;
+    }
+
+    // Recorded into the render queue and drawn by flush() or endFrame(),
+    // by ShapeRenderer and TextRenderer
+    void renderShapes(const ShapeBatch& batch);
     void drawRectangle(float x, float y, float width, float height, const Vector4& color);
     void drawLine(float x1, float y1, float x2, float y2, const Vector4& color,
                   float thickness = 0.02f);
+    void drawText(std::string_view text, float x, float y, const Vector4& color);
+    // Width of a string as drawText() draws it, in scene units
+    float measureText(std::string_view text) const;
+
+    // Drawn immediately, after flushing what is recorded
+    void renderShape(const scene_graph::Shape& shape);
 
-    // Text rendering (delegated to TextRenderer)
-    void drawText(const std::string& text, float x, float y, const Vector4& color);
+    // Commands recorded since the last flush, in recorded order
+    const RenderQueue& getRenderQueue() const {
+        return queue_;
+    }
+    // Commands executed since beginFrame(), in execution order. Recorded and
+    // sorted in headless mode too, where nothing reaches GL
+    const std::vector<RenderCommand>& getSubmittedCommands() const {
+        return submitted_;
+    }
 
     // Accessors for specialized renderers (for advanced usage)
     std::shared_ptr<ShapeRenderer> getShapeRenderer() const;
     std::shared_ptr<TextRenderer> getTextRenderer() const;
+    // GL state shadow shared by all renderers, with redundant call counts
+    std::shared_ptr<RenderState> getRenderState() const;
+    // Camera block contents as last uploaded
+    const CameraUniforms& getCameraUniforms() const {
+        return camera_;
+    }
 
 private:
+    // Fill the camera block from the current viewport and upload it
+    void updateCameraBuffer();
+    // Run the sorted queue through the shape and text renderers
+    void execute(const RenderQueue& queue);
+
     // Mode
     RenderMode mode_ = RenderMode::Normal;
 
     // Component managers and renderers
+    std::shared_ptr<RenderState> renderState_;
     std::shared_ptr<ShaderManager> shaderManager_;
     std::shared_ptr<FontManager> fontManager_;
     std::shared_ptr<TextRenderer> textRenderer_;
     std::shared_ptr<ShapeRenderer> shapeRenderer_;
 
+    // Draws recorded for the next flush, and the ones executed this frame
+    RenderQueue queue_;
+    RenderLayer layer_ = RenderLayer::Scene;
+    std::vector<RenderCommand> submitted_;
+
+    // Camera uniform buffer, bound to kCameraBindingPoint and shared by all
+    // shader programs
+    unsigned int cameraBuffer_ = 0;
+    CameraUniforms camera_;
+
     // Viewport dimensions
     int viewportWidth_ = constants::DEFAULT_WINDOW_WIDTH;
     int viewportHeight_ = constants::DEFAULT_WINDOW_HEIGHT;
@@ -2,18 +2,58 @@
 #ifndef VISUALIZATION_SHADER_MANAGER_H
 #define VISUALIZATION_SHADER_MANAGER_H
 
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <limits>
 #include <memory>
 #include <string>
 
+#include "render_state.h"
 #include "render_types.h"
 #include "types.h"
 
 namespace visualization {
 
+// A shader program resolved once by name, for use on the per-draw path
+struct ShaderHandle {
+    static constexpr std::uint32_t kInvalid = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t index = kInvalid;
+
+    [[nodiscard]] bool isValid() const {
+        return index != kInvalid;
+    }
+};
+
+// The location of a uniform in one shader program, reflected at link time.
+// Invalid for uniforms the program does not use; setting one is a no-op.
+// An id belongs to one link of its program: once the program is rebuilt
+// under the same name, ids resolved before are stale, are rejected by the
+// setters and must be resolved again
+struct UniformId {
+    int location = -1;
+    std::uint32_t program = ShaderHandle::kInvalid;
+    std::uint32_t generation = 0;  // Which link of the program it came from
+
+    [[nodiscard]] bool isValid() const {
+        return location >= 0;
+    }
+};
+
+/**
+ * @brief Compiles and owns the shader programs and sets their uniforms.
+ *
+ * Every active uniform of a program is reflected when it is linked. The fast
+ * path resolves a ShaderHandle and UniformIds once, at initialization, and
+ * then sets uniforms without string hashing or GL queries. Uniforms are set
+ * on the program in use, so call useShader() first. The string overloads
+ * remain for convenience and look the cached locations up by name.
+ */
 class ShaderManager {
 public:
-    ShaderManager();
+    // Programs are bound through the given state tracker, shared with the
+    // renderers that draw with them
+    explicit ShaderManager(
+        std::shared_ptr<RenderState> renderState = std::make_shared<RenderState>());
     ~ShaderManager();
 
     // Delete copy and move operations
@@ -30,10 +70,27 @@ public:
     bool createShaderProgram(const std::string& name, const std::string& vertexSource,
                              const std::string& fragmentSource);
 
+    // Resolve names once; both lookups are invalid for unknown names
+    [[nodiscard]] ShaderHandle getShaderHandle(const std::string& name) const;
+    [[nodiscard]] UniformId getUniformId(ShaderHandle shader, const std::string& name) const;
+    // False for ids resolved before their program was last rebuilt
+    [[nodiscard]] bool isCurrent(UniformId uniform) const;
+
+    // Bind the uniform block of this name to a binding point, in the
+    // programs linked so far and in all later ones
+    void setUniformBlockBinding(const std::string& blockName, unsigned int bindingPoint);
+
     // Shader usage
+    void useShader(ShaderHandle shader);
     void useShader(const std::string& name);
 
-    // Uniform setters
+    // Uniform setters for the program in use; stale ids are reported and
+    // ignored
+    void setUniform(UniformId uniform, const Matrix4& matrix);
+    void setUniform(UniformId uniform, const Vector4& vec);
+    void setUniform(UniformId uniform, float value);
+
+    // Uniform setters by name
     void setUniformMatrix4fv(const std::string& shader, const std::string& name,
                              const Matrix4& matrix);
     void setUniform4f(const std::string& shader, const std::string& name, const Vector4& vec);
@@ -41,12 +98,15 @@ public:
 
     // Getters
     unsigned int getShaderProgram(const std::string& name) const;
+    unsigned int getShaderProgram(ShaderHandle shader) const;
     bool isInitialized() const;
     bool isHeadlessMode() const;
+    const std::shared_ptr<RenderState>& getRenderState() const;
 
 private:
     // Helper methods
     bool compileShader(unsigned int& shader, const std::string& source, const std::string& type);
+    UniformId findUniform(const std::string& shader, const std::string& name) const;
 
     // Implementation details
     struct Impl;
@@ -0,0 +1,96 @@
+// visualization/shape_batch.h
+#ifndef VISUALIZATION_SHAPE_BATCH_H
+#define VISUALIZATION_SHAPE_BATCH_H
+
+#include <scene_graph/affine2.h>
+#include <scene_graph/shape.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "types.h"
+
+namespace visualization {
+
+// Geometry a shape is drawn with
+enum class ShapeKind : std::uint8_t { Rectangle, Circle };
+
+/**
+ * @brief Per-instance vertex data of one shape, as uploaded to the GPU.
+ *
+ * The linear part of the world matrix has the shape's size folded in, so the
+ * unit quad or circle maps straight to world space.
+ */
+struct ShapeInstance {
+    float linear[4];          // a, b, c, d of the sized world matrix
+    float translateDepth[3];  // tx, ty and the depth that encodes draw order
+    float color[4];
+};
+
+/**
+ * @brief The shapes of one frame, gathered in draw order and arranged for
+ * instanced drawing.
+ *
+ * Draw order is kept through depth: every shape gets a depth nearer than all
+ * shapes added before it, so with the depth test on, opaque shapes can be
+ * drawn in any order, all rectangles in one draw and all circles in another.
+ * Translucent shapes must blend over what is behind them, so they follow in
+ * their original order, one draw per run of the same kind.
+ */
+class ShapeBatch {
+public:
+    // A contiguous run of instances drawn with one call
+    struct Range {
+        ShapeKind kind;
+        std::uint32_t first;
+        std::uint32_t count;
+        bool translucent = false;  // Must be drawn in order, after the opaque ranges
+    };
+
+    // A gathered shape, in the order it was added
+    struct Item {
+        const scene_graph::Shape* shape;
+        ShapeKind kind;
+        scene_graph::Affine2 matrix;  // World matrix with the size folded in
+        Vector4 color;
+    };
+
+    // The item for a shape, or nothing for shapes without geometry
+    static std::optional<Item> makeItem(const scene_graph::Shape& shape, const Vector4& color);
+
+    void clear();
+    // Shapes without geometry are ignored, as ShapeRenderer::renderShape() does
+    void add(const scene_graph::Shape& shape, const Vector4& color);
+    // Add another batch's shapes after this one's, as if added here
+    void append(const ShapeBatch& other);
+    void build();
+
+    [[nodiscard]] const std::vector<Item>& getItems() const {
+        return items_;
+    }
+    [[nodiscard]] const std::vector<ShapeInstance>& getInstances() const {
+        return instances_;
+    }
+    [[nodiscard]] const std::vector<Range>& getRanges() const {
+        return ranges_;
+    }
+    [[nodiscard]] std::size_t size() const {
+        return items_.size();
+    }
+    [[nodiscard]] bool empty() const {
+        return items_.empty();
+    }
+
+private:
+    void appendInstance(const Item& item, float depth);
+
+    std::vector<Item> items_;
+    std::vector<ShapeInstance> instances_;
+    std::vector<Range> ranges_;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_SHAPE_BATCH_H
@@ -2,17 +2,29 @@
 #ifndef VISUALIZATION_SHAPE_RENDERER_H
 #define VISUALIZATION_SHAPE_RENDERER_H
 
+#include <scene_graph/aabb.h>
 #include <scene_graph/circle.h>
 #include <scene_graph/rectangle.h>
 #include <scene_graph/shape.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include "primitive_batch.h"
 #include "render_types.h"
 #include "shader_manager.h"
+#include "shape_batch.h"
 
 namespace visualization {
 
+// Totals of rectangles and lines drawn since initialization
+struct PrimitiveStats {
+    std::size_t quads = 0;      // Rectangles and lines drawn
+    std::size_t drawCalls = 0;  // drawPrimitives() calls that drew something
+};
+
 class ShapeRenderer {
 public:
     ShapeRenderer(std::shared_ptr<ShaderManager> shaderManager);
@@ -30,17 +42,37 @@ public:
 
     // Shape rendering
     void renderShape(const scene_graph::Shape& shape);
+    void setInstancingEnabled(bool enabled);
+    bool isInstancingEnabled() const;
+
+    // Command execution: upload a frame's instances once, then draw ranges
+    // of them, clearing the depth that orders a batch before drawing it.
+    // Ranges are drawn one shape at a time when instancing is off, still
+    // ordered by depth
+    void uploadInstances(const std::vector<ShapeInstance>& instances);
+    void clearDepth();
+    void drawInstances(const std::vector<ShapeInstance>& instances, ShapeKind kind,
+                       std::uint32_t first, std::uint32_t count);
 
-    // Basic primitive rendering
-    void drawRectangle(float x, float y, float width, float height, const Vector4& color);
-    void drawLine(float x1, float y1, float x2, float y2, const Vector4& color,
-                  float thickness = 0.02f);
+    // Command execution: upload recorded primitives once, then draw ranges
+    // of quads from them
+    void uploadPrimitives(const std::vector<PrimitiveVertex>& vertices);
+    void drawPrimitives(std::uint32_t firstQuad, std::uint32_t quadCount);
+    const PrimitiveStats& getPrimitiveStats() const;
 
     // Information
     bool isInitialized() const;
     void setViewport(int width, int height);
 
+    // Visible world-space region and the projection that shows it
+    scene_graph::Aabb getViewBounds() const;
+    Matrix4 getProjectionMatrix() const;
+
 private:
+    bool initializePrimitives();
+    bool initializeInstancing();
+    void drawItem(const ShapeBatch::Item& item);
+
     // Shader manager reference
     std::shared_ptr<ShaderManager> shaderManager_;
 
@@ -0,0 +1,112 @@
+// visualization/text_layout_cache.h
+#ifndef VISUALIZATION_TEXT_LAYOUT_CACHE_H
+#define VISUALIZATION_TEXT_LAYOUT_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace visualization {
+
+// A vertex of a glyph quad: scene position, atlas pixel coordinates and color
+struct TextVertex {
+    float x;
+    float y;
+    float u;
+    float v;
+    float r;
+    float g;
+    float b;
+    float a;
+};
+
+// The glyph quads of a string laid out from the origin, and how far it
+// advances the pen
+struct TextLayout {
+    std::vector<TextVertex> vertices;  // Six per glyph, without color
+    float width = 0.0f;
+};
+
+struct TextLayoutCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
+
+/**
+ * @brief Laid out strings by (string, scale), so text drawn every frame is
+ * laid out once.
+ *
+ * The least recently used layouts are evicted once the estimated memory of
+ * all layouts exceeds the budget; the newest layout always stays. A
+ * returned layout stays valid until the next insert() or clear(). Layouts
+ * depend on the font's glyphs, so the cache must be cleared when they
+ * change.
+ */
+class TextLayoutCache {
+public:
+    static constexpr std::size_t kDefaultBudget = 1 << 20;
+
+    explicit TextLayoutCache(std::size_t budgetBytes = kDefaultBudget);
+
+    // The cached layout, marked most recently used, or nullptr
+    const TextLayout* find(std::string_view text, float scale);
+    const TextLayout& insert(std::string_view text, float scale, TextLayout layout);
+    void clear();
+
+    void setBudget(std::size_t budgetBytes);
+    [[nodiscard]] std::size_t getBudget() const {
+        return budget_;
+    }
+    [[nodiscard]] std::size_t getMemoryUsage() const {
+        return usage_;
+    }
+    [[nodiscard]] std::size_t size() const {
+        return entries_.size();
+    }
+    [[nodiscard]] const TextLayoutCacheStats& getStats() const {
+        return stats_;
+    }
+
+private:
+    struct Key {
+        std::string text;
+        float scale;
+
+        bool operator==(const Key& other) const {
+            return scale == other.scale && text == other.text;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        TextLayout layout;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    static std::size_t bytesOf(const Entry& entry);
+    void evict();
+
+    // Most recently used first
+    EntryList entries_;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+
+    // Reused for lookups, so a hit does not allocate
+    Key lookupKey_;
+
+    std::size_t budget_;
+    std::size_t usage_ = 0;
+    TextLayoutCacheStats stats_;
+};
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_TEXT_LAYOUT_CACHE_H
@@ -2,15 +2,24 @@
 #ifndef VISUALIZATION_TEXT_RENDERER_H
 #define VISUALIZATION_TEXT_RENDERER_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "font_manager.h"
 #include "render_types.h"
 #include "shader_manager.h"
+#include "text_layout_cache.h"
 
 namespace visualization {
 
+// Totals since initialization
+struct TextStats {
+    std::size_t glyphs = 0;     // Glyph quads drawn
+    std::size_t drawCalls = 0;  // Flushes that drew something
+};
+
 class TextRenderer {
 public:
     TextRenderer(std::shared_ptr<FontManager> fontManager,
@@ -27,13 +36,24 @@ public:
     bool initialize(RenderMode mode = RenderMode::Normal);
     void cleanup();
 
-    // Text rendering
-    void drawText(const std::string& text, float x, float y, const Vector4& color);
+    // Text rendering; glyphs from the font atlas are queued and drawn
+    // together by flush()
+    void drawText(std::string_view text, float x, float y, const Vector4& color);
+    void flush();
+    const TextStats& getStats() const;
+
+    // Width of a string as drawn, in scene units
+    float measureText(std::string_view text);
+    // Layouts of recently drawn or measured strings
+    TextLayoutCache& getLayoutCache();
 
     // Information
     bool isInitialized() const;
 
 private:
+    // The cached layout of a string, laid out on a miss
+    const TextLayout& layoutText(std::string_view text, float scale);
+
     // Keep references to the managers
     std::shared_ptr<FontManager> fontManager_;
     std::shared_ptr<ShaderManager> shaderManager_;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <string_view>
 #include <utility>  // For std::move
+#include <vector>
 
 #include "constants.h"
 #include "scene_graph/node.h"
@@ -82,6 +84,17 @@ private:
 
     std::vector<NodePosition> nodePositions_;
 
+    // Text queued during layout and drawn after all rows, so the rows'
+    // rectangles and lines are drawn together
+    struct Label {
+        std::string_view text;
+        float x;
+        float y;
+        Vector4 color;
+    };
+
+    std::vector<Label> labels_;
+
     // Scrolling properties
     float scrollPosition_ = 0.0f;
     float contentHeight_ = 0.0f;
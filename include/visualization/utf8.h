@@ -0,0 +1,18 @@
+// visualization/utf8.h
+#ifndef VISUALIZATION_UTF8_H
+#define VISUALIZATION_UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace visualization {
+
+inline constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+// Decode the code point at index and advance index past it. Malformed
+// input decodes as U+FFFD, one byte at a time
+char32_t decodeUtf8(std::string_view text, std::size_t& index);
+
+}  // namespace visualization
+
+#endif  // VISUALIZATION_UTF8_H
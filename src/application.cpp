@@ -17,7 +17,7 @@ Application::Application()
     : window_(std::make_unique<visualization::Window>()),
       renderer_(std::make_shared<visualization::Renderer>()),
       canvas_(std::make_shared<visualization::Canvas>()),
-      root_(std::make_shared<scene_graph::Node>("Root")),
+      root_(nodeArena_.create<scene_graph::Node>("Root")),
       isDragging_(false),
       treeView_(std::make_shared<visualization::TreeView>()),
       draggedNode_(nullptr),
@@ -36,7 +36,8 @@ bool Application::initialize() {
             std::cerr << "GLEW initialization failed: " << glewGetErrorString(err) << std::endl;
             return false;
         }
-        // Initialize renderer
+        // Initialize renderer; distance field text stays sharp at any scale
+        renderer_->setGlyphMode(visualization::GlyphMode::DistanceField);
         try {
             if (!renderer_->initialize()) {
                 std::cerr << "Failed to initialize renderer!\n";
@@ -196,20 +197,22 @@ void Application::handleMouseMoved(double xpos, double ypos) {
             // Calculate rotation factor based on movement distance and direction
             float rotationFactor = movementDistance * direction * constants::WHEEL_ROTATION_FACTOR;
 
+            // Convert to a rotation once per event; each wheel then only
+            // needs a complex multiply. Negative to rotate correctly
+            const scene_graph::Rotation2 wheelDelta =
+                scene_graph::Rotation2::fromDegrees(-rotationFactor);
+
             // Apply rotation to wheel children - need to traverse the hierarchy
             // correctly
-            auto wheelSearch = [&rotationFactor](const std::shared_ptr<scene_graph::Node>& node) {
+            auto wheelSearch = [&wheelDelta](const std::shared_ptr<scene_graph::Node>& node) {
                 if (node->getName().find("Wheel") != std::string::npos) {
-                    float currentRotation = node->getRotation();
-                    node->setRotation(currentRotation -
-                                      rotationFactor);  // Negative to rotate correctly
+                    node->rotateBy(wheelDelta);
                 }
 
                 // Recursively search children for wheels
                 for (const auto& child : node->getChildren()) {
                     if (child->getName().find("Wheel") != std::string::npos) {
-                        float currentRotation = child->getRotation();
-                        child->setRotation(currentRotation - rotationFactor);
+                        child->rotateBy(wheelDelta);
                     }
                 }
             };
@@ -368,7 +371,7 @@ std::shared_ptr<scene_graph::Node> Application::createRectangle(const std::strin
                                                                 const Vector2& size,
                                                                 const Vector2& position,
                                                                 const Vector4& color) {
-    auto rect = std::make_shared<scene_graph::Rectangle>(name, size);
+    auto rect = nodeArena_.create<scene_graph::Rectangle>(name, size);
     rect->setPosition(position);
     rect->setColor(color);
     return rect;
@@ -377,7 +380,7 @@ std::shared_ptr<scene_graph::Node> Application::createRectangle(const std::strin
 std::shared_ptr<scene_graph::Node> Application::createCircle(const std::string& name, float radius,
                                                              const Vector2& position,
                                                              const Vector4& color) {
-    auto circle = std::make_shared<scene_graph::Circle>(name, radius);
+    auto circle = nodeArena_.create<scene_graph::Circle>(name, radius);
     circle->setPosition(position);
     circle->setColor(color);
     return circle;
@@ -537,7 +540,7 @@ std::shared_ptr<scene_graph::Node> Application::createCar(const std::string& nam
                                                           const Vector2& position,
                                                           const Vector4& bodyColor) {
     // Create a parent node for the entire car
-    auto car = std::make_shared<scene_graph::Node>(name);
+    auto car = nodeArena_.create<scene_graph::Node>(name);
     car->setPosition(position);
 
     // Create the car body
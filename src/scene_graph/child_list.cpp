@@ -0,0 +1,76 @@
+#include "scene_graph/child_list.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace scene_graph {
+
+/**
+ * @brief Constructor for the ChildList class.
+ *
+ * @param resource Memory resource for children beyond the inline capacity
+ */
+ChildList::ChildList(std::pmr::memory_resource* resource) : resource_(resource) {
+}
+
+ChildList::~ChildList() {
+    clear();
+    if (!isInline()) {
+        resource_->deallocate(heap_, capacity_ * sizeof(value_type), alignof(value_type));
+    }
+}
+
+/**
+ * @brief Append a child, spilling to the memory resource when full.
+ *
+ * @param child The child to append
+ */
+void ChildList::push_back(const value_type& child) {
+    if (size_ == capacity_) {
+        grow();
+    }
+    new (data() + size_) value_type(child);
+    ++size_;
+}
+
+/**
+ * @brief Remove the children in [first, last), keeping the order of the rest.
+ *
+ * @return Iterator to the child that followed the removed range
+ */
+ChildList::iterator ChildList::erase(iterator first, iterator last) {
+    if (first == last) {
+        return first;
+    }
+    iterator oldEnd = end();
+    iterator newEnd = std::move(last, oldEnd, first);
+    for (iterator it = newEnd; it != oldEnd; ++it) {
+        it->~value_type();
+    }
+    size_ = static_cast<std::uint32_t>(newEnd - begin());
+    return first;
+}
+
+void ChildList::clear() {
+    erase(begin(), end());
+}
+
+void ChildList::grow() {
+    const std::uint32_t newCapacity = capacity_ * 2;
+    auto* buffer = static_cast<value_type*>(
+        resource_->allocate(newCapacity * sizeof(value_type), alignof(value_type)));
+
+    value_type* old = data();
+    for (std::uint32_t i = 0; i < size_; ++i) {
+        new (buffer + i) value_type(std::move(old[i]));
+        old[i].~value_type();
+    }
+
+    if (!isInline()) {
+        resource_->deallocate(heap_, capacity_ * sizeof(value_type), alignof(value_type));
+    }
+    heap_ = buffer;
+    capacity_ = newCapacity;
+}
+
+}  // namespace scene_graph
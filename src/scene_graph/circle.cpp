@@ -17,6 +17,11 @@ namespace scene_graph {
 Circle::Circle(const std::string& name, float radius) : Shape(name), radius_(radius) {
 }
 
+Circle::Circle(std::allocator_arg_t, const Allocator& allocator, const std::string& name,
+               float radius)
+    : Shape(std::allocator_arg, allocator, name), radius_(radius) {
+}
+
 /**
  * @brief Sets the radius of the circle
  *
@@ -28,6 +33,7 @@ Circle::Circle(const std::string& name, float radius) : Shape(name), radius_(rad
  */
 void Circle::setRadius(float radius) {
     radius_ = radius;
+    markBoundsChanged();
 }
 
 /**
@@ -64,8 +70,17 @@ void Circle::render() const {
  * @return true if the point is inside the circle, false otherwise
  */
 bool Circle::containsPoint(const Vector2& point) const {
-    Vector2 localPoint = getLocalTransform().inverseTransformPoint(point);
+    Vector2 localPoint = getGlobalMatrix().inverseTransformPoint(point);
     float distance = length(localPoint);
     return distance <= radius_;
 }
+
+/**
+ * @brief Gets the bounds of the circle in its local space
+ *
+ * @return The square enclosing the circle
+ */
+Aabb Circle::getLocalBounds() const {
+    return Aabb::fromCenterExtents(Vector2(0.0F), Vector2(radius_));
+}
 }  // namespace scene_graph
\ No newline at end of file
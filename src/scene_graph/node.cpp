@@ -1,6 +1,7 @@
 #include "scene_graph/node.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace scene_graph {
 
@@ -9,17 +10,80 @@ namespace scene_graph {
  *
  * @param name node name.
  */
-Node::Node(std::string name) : name_(std::move(name)) {
+Node::Node(std::string_view name) : Node(std::allocator_arg, Allocator(), name) {
+}
+
+/**
+ * @brief Constructor for a node whose name and child list allocate from a
+ * given memory resource, e.g. a NodeArena.
+ *
+ * @param allocator allocator for the name and child list.
+ * @param name node name.
+ */
+Node::Node(std::allocator_arg_t, const Allocator& allocator, std::string_view name)
+    : handle_(NodeRegistry::instance().add(this)), children_(allocator.resource()) {
+    setName(name);
 }
 
 Node::~Node() {
-    std::shared_ptr<Node> parentPtr = parent_.lock();
+    Node* parentPtr = getParentNode();
 
     if (parentPtr) {
-        parentPtr->removeChild(shared_from_this());
+        auto& siblings = parentPtr->children_;
+        siblings.erase(std::remove_if(siblings.begin(), siblings.end(),
+                                      [this](const auto& sibling) { return sibling.get() == this; }),
+                       siblings.end());
+        parentPtr->adjustSubtreeSize(-static_cast<std::ptrdiff_t>(subtreeSize_));
+        parentPtr->markSubtreeBoundsDirty();
+        hierarchyRevision_.fetch_add(1, std::memory_order_relaxed);
     }
 
+    // Invalidate handles first, so children destroyed below see no parent
+    NodeRegistry::instance().remove(handle_);
     children_.clear();
+
+    if (name_) {
+        children_.getResource()->deallocate(name_, nameLength_, 1);
+    }
+}
+
+/**
+ * @brief Set the name of the node.
+ *
+ * The name is copied into a buffer from the node's memory resource, keeping
+ * it out of the node itself. Names longer than kMaxNameLength are truncated.
+ *
+ * @param name The new name.
+ */
+void Node::setName(std::string_view name) {
+    std::pmr::memory_resource* resource = children_.getResource();
+    const auto length = static_cast<std::uint16_t>(std::min(name.size(), kMaxNameLength));
+
+    // Copy before freeing the old buffer, which name may point into
+    char* buffer = nullptr;
+    if (length > 0) {
+        buffer = static_cast<char*>(resource->allocate(length, 1));
+        std::memcpy(buffer, name.data(), length);
+    }
+    if (name_) {
+        resource->deallocate(name_, nameLength_, 1);
+    }
+
+    name_ = buffer;
+    nameLength_ = length;
+}
+
+/**
+ * @brief Get the parent node.
+ *
+ * Compatibility accessor for shared_ptr based code; getParentNode() and
+ * getParentHandle() avoid the reference counting.
+ *
+ * @return The parent, or an empty pointer for a root node.
+ */
+std::weak_ptr<Node> Node::getParent() const {
+    Node* parent = getParentNode();
+    return parent ? parent->weak_from_this() : std::weak_ptr<Node>();
 }
 
 /**
@@ -29,14 +93,18 @@ Node::~Node() {
  */
 void Node::addChild(const std::shared_ptr<Node>& child) {
     // Remove child from any existing parent
-    std::shared_ptr<Node> currentParent = child->parent_.lock();
+    Node* currentParent = child->getParentNode();
     if (currentParent) {
         // Remove from current parent
         currentParent->removeChild(child);
     }
 
-    child->parent_ = shared_from_this();
+    child->parent_ = handle_;
     children_.push_back(child);
+    hierarchyRevision_.fetch_add(1, std::memory_order_relaxed);
+    adjustSubtreeSize(static_cast<std::ptrdiff_t>(child->subtreeSize_));
+    child->markGlobalTransformDirty();
+    markSubtreeBoundsDirty();
 }
 
 /**
@@ -45,22 +113,160 @@ void Node::addChild(const std::shared_ptr<Node>& child) {
  * @param child node to remove.
  */
 void Node::removeChild(const std::shared_ptr<Node>& child) {
-    child->parent_.reset();
-    children_.erase(std::remove(children_.begin(), children_.end(), child), children_.end());
+    // Finish with child before erasing, which may release the last reference
+    child->parent_ = NodeHandle();
+    child->markGlobalTransformDirty();
+    const auto removedSize = static_cast<std::ptrdiff_t>(child->subtreeSize_);
+
+    auto it = std::remove(children_.begin(), children_.end(), child);
+    if (it != children_.end()) {
+        children_.erase(it, children_.end());
+        adjustSubtreeSize(-removedSize);
+        markSubtreeBoundsDirty();
+        hierarchyRevision_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Update the cached subtree size of this node and its ancestors.
+ *
+ * @param delta Number of nodes added to (or removed from) the subtree.
+ */
+void Node::adjustSubtreeSize(std::ptrdiff_t delta) {
+    for (Node* node = this; node != nullptr;) {
+        node->subtreeSize_ = static_cast<std::uint32_t>(
+            static_cast<std::ptrdiff_t>(node->subtreeSize_) + delta);
+        node = node->getParentNode();
+    }
+}
+
+/**
+ * @brief Get the global transform matrix of the node.
+ *
+ * The world matrix is cached and only recomputed when this node or one
+ * of its ancestors has changed since the last call, so repeated queries
+ * during a frame cost a flag check instead of a walk up the parent chain.
+ *
+ * @return The global transform matrix of the node.
+ */
+const Affine2& Node::getGlobalMatrix() const {
+    if (globalTransformDirty_) {
+        const Node* parent = getParentNode();
+        if (parent) {
+            // Combine parent's global transform with our local transform
+            globalMatrix_ = parent->getGlobalMatrix() * transform_.getAffine();
+        } else {
+            globalMatrix_ = transform_.getAffine();
+        }
+        globalTransformDirty_ = false;
+    }
+    return globalMatrix_;
 }
 
 /**
  * @brief Get the global transform of the node.
  *
+ * Wraps the cached world matrix; position, rotation and scale are
+ * decomposed from it on first access.
+ *
  * @return The global transform of the node.
  */
 Transform Node::getGlobalTransform() const {
-    shared_ptr<Node> parent = parent_.lock();
-    if (parent) {
-        // Combine parent's global transform with our local transform
-        return Transform::combine(parent->getGlobalTransform(), transform_);
+    Transform world;
+    world.setAffine(getGlobalMatrix());
+    return world;
+}
+
+/**
+ * @brief Invalidate the cached world transform of this node and its subtree.
+ *
+ * A clean node always has clean ancestors, so a node that is already dirty
+ * has a dirty subtree and the propagation can stop there. The subtree bounds
+ * of every node whose world transform changes, and of its ancestors, are
+ * invalidated along the way.
+ */
+void Node::markGlobalTransformDirty() {
+    if (globalTransformDirty_) {
+        return;
+    }
+    sceneBoundsRevision_.fetch_add(1, std::memory_order_relaxed);
+    markSubtreeBoundsDirty();
+    markDescendantsDirty();
+}
+
+void Node::markDescendantsDirty() {
+    globalTransformDirty_ = true;
+    subtreeBoundsDirty_ = true;
+    ++boundsRevision_;
+    for (const auto& child : children_) {
+        if (!child->globalTransformDirty_) {
+            child->markDescendantsDirty();
+        }
     }
-    return transform_;
+}
+
+/**
+ * @brief Invalidate the cached bounds of this node's subtree and of every
+ * subtree containing it.
+ *
+ * Bounds are only ever recomputed top-down, so a node with dirty bounds has
+ * ancestors with dirty bounds and the walk up can stop there.
+ */
+void Node::markSubtreeBoundsDirty() {
+    for (Node* node = this; node != nullptr && !node->subtreeBoundsDirty_;) {
+        node->subtreeBoundsDirty_ = true;
+        node = node->getParentNode();
+    }
+}
+
+/**
+ * @brief Record that the extent of this node changed, e.g. a resized shape.
+ */
+void Node::markBoundsChanged() {
+    ++boundsRevision_;
+    sceneBoundsRevision_.fetch_add(1, std::memory_order_relaxed);
+    markSubtreeBoundsDirty();
+}
+
+/**
+ * @brief Get the bounds of the node in its own coordinate space.
+ *
+ * A plain node has no extent of its own; shapes override this.
+ *
+ * @return An empty box.
+ */
+Aabb Node::getLocalBounds() const {
+    return Aabb();
+}
+
+/**
+ * @brief Get the axis-aligned world-space bounds of this node alone.
+ *
+ * @return The local bounds mapped through the world transform.
+ */
+Aabb Node::getWorldBounds() const {
+    return getLocalBounds().transformed(getGlobalMatrix());
+}
+
+/**
+ * @brief Get the world-space bounds of this node and all its descendants.
+ *
+ * Cached like the world transform: recomputed only for subtrees in which a
+ * transform, a shape's size or the hierarchy changed since the last call.
+ * Traversals can skip a whole subtree whose bounds miss the region they are
+ * interested in.
+ *
+ * @return The subtree bounds; empty if nothing in the subtree has extent.
+ */
+const Aabb& Node::getSubtreeBounds() const {
+    if (subtreeBoundsDirty_) {
+        subtreeBounds_ = getWorldBounds();
+        for (const auto& child : children_) {
+            subtreeBounds_.merge(child->getSubtreeBounds());
+        }
+        subtreeBoundsDirty_ = false;
+    }
+    return subtreeBounds_;
 }
 
 /**
@@ -70,6 +276,7 @@ Transform Node::getGlobalTransform() const {
  */
 void Node::setPosition(const Vector2& position) {
     transform_.setPosition(position);
+    markGlobalTransformDirty();
 }
 
 /**
@@ -88,6 +295,7 @@ Vector2 Node::getPosition() const {
  */
 void Node::setRotation(float rotation) {
     transform_.setRotation(rotation);
+    markGlobalTransformDirty();
 }
 
 /**
@@ -99,6 +307,19 @@ float Node::getRotation() const {
     return transform_.getRotation();
 }
 
+/**
+ * @brief Rotate the node further by a delta rotation.
+ *
+ * Cheaper than setRotation(getRotation() + angle) when the same delta is
+ * applied to many nodes, as it involves no degree conversion.
+ *
+ * @param delta The rotation to add.
+ */
+void Node::rotateBy(const Rotation2& delta) {
+    transform_.rotateBy(delta);
+    markGlobalTransformDirty();
+}
+
 /**
  * @brief Set the scale of the node.
  *
@@ -106,6 +327,7 @@ float Node::getRotation() const {
  */
 void Node::setScale(const Vector2& scale) {
     transform_.setScale(scale);
+    markGlobalTransformDirty();
 }
 
 /**
@@ -118,11 +340,11 @@ Vector2 Node::getScale() const {
 }
 
 bool Node::hasParent(const shared_ptr<Node>& potentialParent) const {
-    return getParent().lock() == potentialParent;
+    return getParentNode() == potentialParent.get();
 }
 
 bool Node::isOrphaned() const {
-    return getParent().expired();
+    return getParentNode() == nullptr;
 }
 
 }  // namespace scene_graph
@@ -0,0 +1,13 @@
+#include "scene_graph/node_arena.h"
+
+namespace scene_graph {
+
+/**
+ * @brief Constructor for the NodeArena class.
+ *
+ * No memory is allocated until the first node is created.
+ */
+NodeArena::NodeArena() : upstream_(kInitialChunkSize), pool_(&upstream_) {
+}
+
+}  // namespace scene_graph
@@ -0,0 +1,53 @@
+#include "scene_graph/node_handle.h"
+
+namespace scene_graph {
+
+/**
+ * @brief The registry shared by all nodes.
+ *
+ * Constructed by the first Node, so it outlives every node, including nodes
+ * held in static variables.
+ */
+NodeRegistry& NodeRegistry::instance() {
+    static NodeRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Register a node, reusing a free slot if there is one.
+ *
+ * @param node The node to register
+ * @return The handle for the node
+ */
+NodeHandle NodeRegistry::add(Node* node) {
+    std::uint32_t index = 0;
+    if (freeSlots_.empty()) {
+        index = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    } else {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+
+    Slot& slot = slots_[index];
+    slot.node = node;
+    return {index, slot.generation};
+}
+
+/**
+ * @brief Unregister a node and invalidate all handles to it.
+ *
+ * @param handle The handle returned by add()
+ */
+void NodeRegistry::remove(NodeHandle handle) {
+    if (!isValid(handle)) {
+        return;
+    }
+
+    Slot& slot = slots_[handle.index];
+    slot.node = nullptr;
+    ++slot.generation;
+    freeSlots_.push_back(handle.index);
+}
+
+}  // namespace scene_graph
@@ -1,5 +1,7 @@
 #include "scene_graph/rectangle.h"
 
+#include <cmath>
+
 namespace scene_graph {
 
 /**
@@ -14,6 +16,11 @@ namespace scene_graph {
 Rectangle::Rectangle(const std::string& name, const Vector2& size) : Shape(name), size_(size) {
 }
 
+Rectangle::Rectangle(std::allocator_arg_t, const Allocator& allocator, const std::string& name,
+                     const Vector2& size)
+    : Shape(std::allocator_arg, allocator, name), size_(size) {
+}
+
 /**
  * @brief Sets the size of the rectangle
  *
@@ -25,6 +32,7 @@ Rectangle::Rectangle(const std::string& name, const Vector2& size) : Shape(name)
  */
 void Rectangle::setSize(const Vector2& size) {
     size_ = size;
+    markBoundsChanged();
 }
 
 /**
@@ -58,9 +66,18 @@ void Rectangle::render() const {
  * @return true if the point is inside the rectangle, false otherwise
  */
 bool Rectangle::containsPoint(const Vector2& point) const {
-    Vector2 localPoint = getLocalTransform().inverseTransformPoint(point);
+    Vector2 localPoint = getGlobalMatrix().inverseTransformPoint(point);
     float halfWidth = size_.x / 2.0F;
     float halfHeight = size_.y / 2.0F;
-    return abs(localPoint.x) <= halfWidth && abs(localPoint.y) <= halfHeight;
+    return std::abs(localPoint.x) <= halfWidth && std::abs(localPoint.y) <= halfHeight;
+}
+
+/**
+ * @brief Gets the bounds of the rectangle in its local space
+ *
+ * @return A box of the rectangle's size centered on the origin
+ */
+Aabb Rectangle::getLocalBounds() const {
+    return Aabb::fromCenterExtents(Vector2(0.0F), size_ * 0.5F);
 }
 }  // namespace scene_graph
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "scene_graph/scene_storage.h"
+
+#include <cmath>
+
+#include "scene_graph/node.h"
+
+namespace scene_graph {
+
+/**
+ * @brief Append a slot for a new node.
+ *
+ * The parent must already be stored, which keeps the buffers in
+ * parent-before-child order and lets updateWorldTransforms() run as a
+ * single forward sweep.
+ *
+ * @param parent Slot of the parent node, or kInvalidSlot for a root
+ * @param local Initial local transform of the node
+ * @return The new slot, or kInvalidSlot if the parent is not stored yet
+ */
+SceneStorage::Slot SceneStorage::add(Slot parent, const Transform& local) {
+    if (parent != kInvalidSlot && parent >= size()) {
+        return kInvalidSlot;
+    }
+
+    auto slot = static_cast<Slot>(size());
+    parents_.push_back(parent);
+    positionsX_.push_back(local.getPosition().x);
+    positionsY_.push_back(local.getPosition().y);
+    rotationsCos_.push_back(local.getRotation2().cosine);
+    rotationsSin_.push_back(local.getRotation2().sine);
+    scalesX_.push_back(local.getScale().x);
+    scalesY_.push_back(local.getScale().y);
+    worldMatrices_.emplace_back();
+    return slot;
+}
+
+void SceneStorage::reserve(std::size_t capacity) {
+    parents_.reserve(capacity);
+    positionsX_.reserve(capacity);
+    positionsY_.reserve(capacity);
+    rotationsCos_.reserve(capacity);
+    rotationsSin_.reserve(capacity);
+    scalesX_.reserve(capacity);
+    scalesY_.reserve(capacity);
+    worldMatrices_.reserve(capacity);
+}
+
+void SceneStorage::clear() {
+    parents_.clear();
+    positionsX_.clear();
+    positionsY_.clear();
+    rotationsCos_.clear();
+    rotationsSin_.clear();
+    scalesX_.clear();
+    scalesY_.clear();
+    worldMatrices_.clear();
+}
+
+/**
+ * @brief Flatten a Node hierarchy into SoA storage.
+ *
+ * Nodes are stored in pre-order, so slot 0 is the root and every node's
+ * slot is greater than its parent's.
+ *
+ * @param root Root of the hierarchy to copy
+ * @return Storage holding the local transforms of the whole hierarchy
+ */
+SceneStorage SceneStorage::fromNode(const Node& root) {
+    SceneStorage storage;
+    storage.addSubtree(root, kInvalidSlot);
+    storage.updateWorldTransforms();
+    return storage;
+}
+
+SceneStorage::Slot SceneStorage::addSubtree(const Node& node, Slot parent) {
+    Slot slot = add(parent, node.getLocalTransform());
+    for (const auto& child : node.getChildren()) {
+        addSubtree(*child, slot);
+    }
+    return slot;
+}
+
+/**
+ * @brief Recompute every world matrix from the local transforms.
+ *
+ * Builds each local matrix in the same SRT order as Transform and composes
+ * it with the parent's world matrix. Rotations are stored as cosine/sine
+ * pairs, so the sweep makes no trig calls. Because parents come first, the
+ * parent's world matrix is always up to date when a child is visited.
+ */
+void SceneStorage::updateWorldTransforms() {
+    const std::size_t count = size();
+    for (std::size_t i = 0; i < count; ++i) {
+        const Affine2 local =
+            Affine2::fromTRS(Vector2(positionsX_[i], positionsY_[i]), rotationsCos_[i],
+                             rotationsSin_[i], Vector2(scalesX_[i], scalesY_[i]));
+
+        const Slot parent = parents_[i];
+        worldMatrices_[i] = parent == kInvalidSlot ? local : worldMatrices_[parent] * local;
+    }
+}
+
+void SceneStorage::setPosition(Slot slot, const Vector2& position) {
+    positionsX_[slot] = position.x;
+    positionsY_[slot] = position.y;
+}
+
+Vector2 SceneStorage::getPosition(Slot slot) const {
+    return {positionsX_[slot], positionsY_[slot]};
+}
+
+/**
+ * @brief Set the local rotation of a slot.
+ *
+ * Uses the same degree convention as Transform::setRotation.
+ *
+ * @param slot Slot to update
+ * @param rotation Rotation in degrees
+ */
+void SceneStorage::setRotation(Slot slot, float rotation) {
+    const float k360 = 360.0F;
+    rotation = std::fmod(rotation, k360);
+    if (rotation < 0.0F) {
+        rotation += k360;
+    }
+    const Rotation2 unit = Rotation2::fromDegrees(rotation);
+    rotationsCos_[slot] = unit.cosine;
+    rotationsSin_[slot] = unit.sine;
+}
+
+float SceneStorage::getRotation(Slot slot) const {
+    return Rotation2{rotationsCos_[slot], rotationsSin_[slot]}.toDegrees();
+}
+
+void SceneStorage::setScale(Slot slot, const Vector2& scale) {
+    scalesX_[slot] = scale.x;
+    scalesY_[slot] = scale.y;
+}
+
+Vector2 SceneStorage::getScale(Slot slot) const {
+    return {scalesX_[slot], scalesY_[slot]};
+}
+
+NodeView SceneStorage::view(Slot slot) {
+    return {*this, slot};
+}
+
+}  // namespace scene_graph
@@ -14,7 +14,11 @@ namespace scene_graph {
  *
  * @param name Unique identifier for the shape, used in the scene hierarchy
  */
-Shape::Shape(std::string name) : Node(std::move(name)) {
+Shape::Shape(std::string_view name) : Node(name) {
+}
+
+Shape::Shape(std::allocator_arg_t, const Allocator& allocator, std::string_view name)
+    : Node(std::allocator_arg, allocator, name) {
 }
 
 /**
@@ -40,4 +44,15 @@ const Vector4& Shape::getColor() const {
     return color_;
 }
 
+/**
+ * @brief Gets the bounds of the shape in its local space
+ *
+ * Shapes that do not know their extent are treated as covering everything.
+ *
+ * @return An infinite box
+ */
+Aabb Shape::getLocalBounds() const {
+    return Aabb::infinite();
+}
+
 }  // namespace scene_graph
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "scene_graph/shape_bvh.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "scene_graph/shape.h"
+
+namespace scene_graph {
+
+namespace {
+
+constexpr std::uint32_t kNoPriority = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t kNoParent = std::numeric_limits<std::uint32_t>::max();
+
+// A median split keeps the tree balanced, so this bounds the traversal stack
+constexpr std::size_t kMaxDepth = 64;
+
+}  // namespace
+
+/**
+ * @brief Build the hierarchy from scratch.
+ *
+ * @param shapesInPriorityOrder Shapes to index; earlier shapes win hit tests
+ */
+void ShapeBvh::build(const std::vector<Shape*>& shapesInPriorityOrder) {
+    clear();
+    entries_.reserve(shapesInPriorityOrder.size());
+    for (Shape* shape : shapesInPriorityOrder) {
+        const auto priority = static_cast<std::uint32_t>(entries_.size());
+        // Reading the bounds brings the shape's world transform up to date,
+        // so any later change moves its revision
+        const Aabb bounds = shape->getWorldBounds();
+        entries_.push_back({bounds, shape, priority, shape->getBoundsRevision(), 0});
+    }
+
+    if (!entries_.empty()) {
+        nodes_.reserve(2 * entries_.size() / kMaxLeafSize + 1);
+        parents_.reserve(nodes_.capacity());
+        buildRange(0, static_cast<std::uint32_t>(entries_.size()), kNoParent);
+    }
+}
+
+/**
+ * @brief Update the bounds of the shapes that moved or resized since they
+ * were last read.
+ *
+ * Cheaper than build(): no sorting and no allocation. Each shape is checked
+ * by comparing one counter, and only changed shapes have their bounds
+ * recomputed and their leaf-to-root path refit. The tree may get looser as
+ * shapes move far from where they were at build time, but queries stay
+ * exact.
+ *
+ * @return The number of shapes whose bounds were updated
+ */
+std::size_t ShapeBvh::refit() {
+    std::size_t updated = 0;
+    for (Entry& entry : entries_) {
+        const std::uint32_t revision = entry.shape->getBoundsRevision();
+        if (revision == entry.boundsRevision) {
+            continue;
+        }
+        entry.bounds = entry.shape->getWorldBounds();
+        entry.boundsRevision = revision;
+        ++updated;
+
+        // A path shared with an earlier changed shape is refit again, so
+        // every ancestor ends up covering all its changed leaves
+        for (std::uint32_t index = entry.leaf; index != kNoParent; index = parents_[index]) {
+            refitNode(index);
+        }
+    }
+    return updated;
+}
+
+void ShapeBvh::refitNode(std::uint32_t index) {
+    BvhNode& node = nodes_[index];
+    node.bounds = Aabb();
+    if (node.count > 0) {
+        for (std::uint32_t e = node.first; e < node.first + node.count; ++e) {
+            node.bounds.merge(entries_[e].bounds);
+        }
+    } else {
+        node.bounds.merge(nodes_[index + 1].bounds);
+        node.bounds.merge(nodes_[node.first].bounds);
+    }
+}
+
+void ShapeBvh::clear() {
+    entries_.clear();
+    nodes_.clear();
+    parents_.clear();
+}
+
+/**
+ * @brief Find the highest-priority shape containing a point.
+ *
+ * Bounds only select candidates; the answer is decided by
+ * Shape::containsPoint(), so it is exact for rotated and round shapes.
+ *
+ * @param point The point in world coordinates
+ * @return The shape, or nullptr if no shape contains the point
+ */
+Shape* ShapeBvh::hitTest(const Vector2& point) const {
+    if (nodes_.empty()) {
+        return nullptr;
+    }
+
+    std::uint32_t stack[kMaxDepth];
+    std::size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    std::uint32_t bestPriority = kNoPriority;
+    Shape* best = nullptr;
+
+    while (stackSize > 0) {
+        const std::uint32_t index = stack[--stackSize];
+        const BvhNode& node = nodes_[index];
+        if (node.minPriority >= bestPriority || !node.bounds.contains(point)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (std::uint32_t e = node.first; e < node.first + node.count; ++e) {
+                const Entry& entry = entries_[e];
+                if (entry.priority < bestPriority && entry.bounds.contains(point) &&
+                    entry.shape->containsPoint(point)) {
+                    bestPriority = entry.priority;
+                    best = entry.shape;
+                }
+            }
+            continue;
+        }
+
+        // Visit the child that may hold the better hit first, so the other
+        // one is more likely to be pruned
+        std::uint32_t first = index + 1;
+        std::uint32_t second = node.first;
+        if (nodes_[second].minPriority < nodes_[first].minPriority) {
+            std::swap(first, second);
+        }
+        stack[stackSize++] = second;
+        stack[stackSize++] = first;
+    }
+    return best;
+}
+
+std::uint32_t ShapeBvh::buildRange(std::uint32_t first, std::uint32_t count,
+                                   std::uint32_t parent) {
+    const auto index = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.push_back({});
+    parents_.push_back(parent);
+
+    Aabb bounds;
+    Aabb centers;
+    std::uint32_t minPriority = kNoPriority;
+    for (std::uint32_t e = first; e < first + count; ++e) {
+        bounds.merge(entries_[e].bounds);
+        const Vector2 center = entries_[e].bounds.getCenter();
+        centers.merge({center, center});
+        minPriority = std::min(minPriority, entries_[e].priority);
+    }
+    nodes_[index].bounds = bounds;
+    nodes_[index].minPriority = minPriority;
+
+    if (count <= kMaxLeafSize) {
+        nodes_[index].first = first;
+        nodes_[index].count = count;
+        for (std::uint32_t e = first; e < first + count; ++e) {
+            entries_[e].leaf = index;
+        }
+        return index;
+    }
+
+    // Split at the median center along the longer axis
+    const Vector2 extent = centers.getSize();
+    const bool splitX = extent.x >= extent.y;
+    const std::uint32_t half = count / 2;
+    auto begin = entries_.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [splitX](const Entry& a, const Entry& b) {
+        return splitX ? a.bounds.getCenter().x < b.bounds.getCenter().x
+                      : a.bounds.getCenter().y < b.bounds.getCenter().y;
+    });
+
+    buildRange(first, half, index);
+    const std::uint32_t right = buildRange(first + half, count - half, index);
+    nodes_[index].first = right;
+    nodes_[index].count = 0;
+    return index;
+}
+
+}  // namespace scene_graph
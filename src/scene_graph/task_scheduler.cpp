@@ -0,0 +1,200 @@
+#include "scene_graph/task_scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace scene_graph {
+
+namespace {
+
+// Identifies the queue owned by the current thread, if it is a worker
+thread_local const TaskScheduler* currentScheduler = nullptr;
+thread_local std::size_t currentIndex = 0;
+// The scheduler whose task the current thread is running, if any
+thread_local const TaskScheduler* runningScheduler = nullptr;
+
+}  // namespace
+
+/**
+ * @brief Start the worker threads.
+ *
+ * @param threadCount Number of threads to run tasks on, including the
+ * thread that calls wait(); 0 picks std::thread::hardware_concurrency()
+ */
+TaskScheduler::TaskScheduler(std::size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    queues_.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    // Queue 0 is served by the waiting thread
+    workers_.reserve(threadCount - 1);
+    for (std::size_t i = 1; i < threadCount; ++i) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+/**
+ * @brief Finish all queued tasks, then stop and join the workers.
+ */
+TaskScheduler::~TaskScheduler() {
+    try {
+        wait();
+    } catch (...) {
+        // Nobody is left to report a failed task to
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeUp_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queue a task.
+ *
+ * From inside a task the new task goes to the running thread's own queue,
+ * from anywhere else to queue 0.
+ *
+ * @param task The task to run
+ */
+void TaskScheduler::submit(Task task) {
+    pending_.fetch_add(1);
+
+    WorkQueue& queue = *queues_[currentQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+
+    // Taking the lock orders this with a worker checking queued_ before
+    // going to sleep, so the wake-up cannot be lost
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wakeUp_.notify_one();
+}
+
+/**
+ * @brief Run tasks on the calling thread until all submitted tasks are done.
+ *
+ * Rethrows the first exception a task threw since the last call, after
+ * every task has finished.
+ *
+ * @throws std::logic_error if called from one of this scheduler's tasks
+ */
+void TaskScheduler::wait() {
+    // Fails the calling task, so the outer wait() reports it
+    if (runningScheduler == this) {
+        throw std::logic_error("TaskScheduler::wait() called from one of its own tasks");
+    }
+
+    const std::size_t index = currentQueueIndex();
+    while (pending_.load() > 0) {
+        if (runOne(index)) {
+            continue;
+        }
+
+        // Everything left is running on other threads; sleep until one of
+        // them finishes or submits more work
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeUp_.wait(lock, [this]() { return pending_.load() == 0 || queued_.load() > 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskScheduler::workerLoop(std::size_t index) {
+    currentScheduler = this;
+    currentIndex = index;
+
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeUp_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Run one task from the own queue, or stolen from another.
+ *
+ * @param index Queue owned by the calling thread
+ * @return False if no task was available
+ */
+bool TaskScheduler::runOne(std::size_t index) {
+    Task task;
+    if (!popLocal(index, task) && !steal(index, task)) {
+        return false;
+    }
+    queued_.fetch_sub(1);
+
+    // A throwing task must still count as finished, or wait() never returns
+    const TaskScheduler* outer = runningScheduler;
+    runningScheduler = this;
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+    runningScheduler = outer;
+
+    if (pending_.fetch_sub(1) == 1) {
+        // Last task done, release wait()
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        wakeUp_.notify_all();
+    }
+    return true;
+}
+
+bool TaskScheduler::popLocal(std::size_t index, Task& task) {
+    WorkQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskScheduler::steal(std::size_t thief, Task& task) {
+    const std::size_t count = queues_.size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        WorkQueue& victim = *queues_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t TaskScheduler::currentQueueIndex() const {
+    return currentScheduler == this ? currentIndex : 0;
+}
+
+}  // namespace scene_graph
@@ -1,5 +1,7 @@
 #include "scene_graph/transform.h"
 
+#include <cmath>
+
 #include "types.h"
 
 namespace scene_graph {
@@ -14,11 +16,7 @@ namespace scene_graph {
  *
  * We use this as the starting point for all scene objects.
  */
-Transform::Transform()
-    : position_(Vector2(0.0F, 0.0F)),
-      rotation_(radians(0.0F)),
-      scale_(Vector2(1.0F, 1.0F)),
-      matrix_(Matrix4(1.0F)) {
+Transform::Transform() : rotation_(), scale_(Vector2(1.0F, 1.0F)), matrix_() {
     updateMatrix();
 }
 
@@ -28,17 +26,18 @@ Transform::Transform()
  * Duplicates an existing transform, which we need for cloning objects
  * or creating related transforms with similar properties.
  *
- * We explicitly recalculate the matrix rather than just copying it to
- * ensure consistent behavior with our decomposition methods.
+ * The matrix is copied as is, so copying a composed transform does not
+ * force its components to be decomposed.
  *
  * @param original The transform to copy values from
  */
 Transform::Transform(const Transform& original)
-    : position_(original.position_),
-      rotation_(original.rotation_),
+    : rotation_(original.rotation_),
       scale_(original.scale_),
-      matrix_(original.matrix_) {
-    updateMatrix();
+      matrix_(original.matrix_),
+      rotationDegrees_(original.rotationDegrees_),
+      rotationDegreesValid_(original.rotationDegreesValid_),
+      decomposed_(original.decomposed_) {
 }
 
 /**
@@ -51,10 +50,12 @@ Transform::Transform(const Transform& original)
  * @return Reference to this transform after assignment
  */
 Transform& Transform::operator=(const Transform& original) {
-    position_ = original.position_;
     rotation_ = original.rotation_;
     scale_ = original.scale_;
-    updateMatrix();
+    matrix_ = original.matrix_;
+    rotationDegrees_ = original.rotationDegrees_;
+    rotationDegreesValid_ = original.rotationDegreesValid_;
+    decomposed_ = original.decomposed_;
     return *this;
 }
 
@@ -62,10 +63,12 @@ Transform& Transform::operator=(const Transform& original) {
  * @brief Sets the rotation of the transform.
  *
  * We work with degrees externally for user-friendliness, but store
- * radians internally for efficiency.
+ * a unit complex number internally. This is the only place degrees are
+ * converted on the way in.
  *
  * Normalizes rotation to [0, 360) to avoid growing values when
- * objects rotate continuously in one direction.
+ * objects rotate continuously in one direction. The normalized value is
+ * kept so getRotation() returns it exactly.
  *
  * @param rotation The rotation in degrees to set
  */
@@ -76,29 +79,52 @@ void Transform::setRotation(float rotation) {
     if (rotation < 0.0F) {
         rotation += k360;
     }
-    rotation_ = radians(rotation);
+    setRotation(Rotation2::fromDegrees(rotation));
+    rotationDegrees_ = rotation;
+    rotationDegreesValid_ = true;
+}
+
+/**
+ * @brief Sets the rotation from a unit complex number.
+ *
+ * @param rotation The rotation to set
+ */
+void Transform::setRotation(const Rotation2& rotation) {
+    ensureDecomposed();
+    rotation_ = rotation;
+    rotationDegreesValid_ = false;
     updateMatrix();
 }
 
+/**
+ * @brief Rotates the transform further by a delta rotation.
+ *
+ * A complex multiply, so callers that apply the same delta repeatedly
+ * (e.g. spinning wheels while dragging) can convert it from degrees once.
+ * The result is renormalized to keep rounding errors from accumulating.
+ *
+ * @param delta The rotation to add
+ */
+void Transform::rotateBy(const Rotation2& delta) {
+    ensureDecomposed();
+    setRotation((rotation_ * delta).normalized());
+}
+
 /**
  * @brief Gets the current rotation of the transform.
  *
- * Converts internal radians to degrees and normalizes the result
- * to ensure consistent rotation values for the UI.
+ * Converts the internal complex number to degrees on first use and
+ * caches the result until the rotation changes again.
  *
  * @return The rotation in degrees in the range [0, 360)
  */
 float Transform::getRotation() const {
-    float rotationDegrees = degrees(rotation_);
-
-    // Normalize to [0, 360)
-    const float k360 = 360.0F;
-    rotationDegrees = fmod(rotationDegrees, k360);
-    if (rotationDegrees < 0.0F) {
-        rotationDegrees += k360;
+    ensureDecomposed();
+    if (!rotationDegreesValid_) {
+        rotationDegrees_ = rotation_.toDegrees();
+        rotationDegreesValid_ = true;
     }
-
-    return rotationDegrees;
+    return rotationDegrees_;
 }
 
 /**
@@ -110,47 +136,64 @@ float Transform::getRotation() const {
  * hierarchical objects.
  *
  * This ordering ensures wheels rotate properly around their centers when
- * attached to moving cars, for example.
+ * attached to moving cars, for example. The product is written out in
+ * closed form rather than multiplying three 4x4 matrices.
  */
 void Transform::updateMatrix() {
-    Matrix4 scaleMatrix = scale(Matrix4(1.0F), Vector3(scale_.x, scale_.y, 1.0f));
-    Matrix4 rotationMatrix = rotate(Matrix4(1.0F), rotation_, Vector3(0.0F, 0.0F, 1.0F));
-    Matrix4 translationMatrix = translate(Matrix4(1.0F), Vector3(position_.x, position_.y, 0.0F));
-    matrix_ = translationMatrix * rotationMatrix * scaleMatrix;
+    matrix_ = Affine2::fromTRS(getPosition(), rotation_.cosine, rotation_.sine, scale_);
 }
 
 /**
  * @brief Sets the transformation matrix and extracts components.
  *
- * Used when working with external matrix sources or when propagating
- * transforms through the scene graph hierarchy. This was tricky to get right!
- *
- * The decomposition process is sensitive to numerical precision, especially
- * for rotation extraction when scale approaches zero.
+ * Used when working with external matrix sources. Only the 2D affine part
+ * of the matrix is kept.
  *
  * @param matrix The 4x4 transformation matrix to set
  */
 void Transform::setMatrix(const Matrix4& matrix) {
+    setAffine(Affine2::fromMatrix4(matrix));
+}
+
+/**
+ * @brief Sets the affine matrix.
+ *
+ * Used when propagating transforms through the scene graph hierarchy.
+ * Only the matrix is stored; position, rotation and scale are extracted
+ * by decompose() if and when they are asked for, which keeps sqrt and
+ * atan2 out of hierarchy propagation.
+ *
+ * @param matrix The 2D affine matrix to set
+ */
+void Transform::setAffine(const Affine2& matrix) {
     matrix_ = matrix;
+    decomposed_ = false;
+}
 
-    // Extract translation directly
-    position_.x = matrix_[3][0];
-    position_.y = matrix_[3][1];
+/**
+ * @brief Extracts scale and rotation from the matrix.
+ *
+ * This was tricky to get right! The decomposition process is sensitive to
+ * numerical precision, especially for rotation extraction when scale
+ * approaches zero. The position needs no extraction, it is the matrix
+ * translation.
+ */
+void Transform::decompose() const {
+    decomposed_ = true;
+    rotationDegreesValid_ = false;
 
     // Extract scale - use length of the basis vectors
-    scale_.x = glm::length(glm::vec2(matrix_[0][0], matrix_[0][1]));
-    scale_.y = glm::length(glm::vec2(matrix_[1][0], matrix_[1][1]));
+    scale_.x = glm::length(Vector2(matrix_.a, matrix_.b));
+    scale_.y = glm::length(Vector2(matrix_.c, matrix_.d));
 
     // Extract rotation
     const float kMinScale = 0.0001F;
     if (scale_.x > kMinScale) {
-        // Calculate rotation from the normalized x basis vector
-        float cosTheta = matrix_[0][0] / scale_.x;
-        float sinTheta = matrix_[0][1] / scale_.x;
-        rotation_ = atan2(sinTheta, cosTheta);
+        // The normalized x basis vector is the rotation
+        rotation_ = {matrix_.a / scale_.x, matrix_.b / scale_.x};
     } else {
         // Avoid division by near-zero scale
-        rotation_ = 0.0F;
+        rotation_ = Rotation2();
     }
 }
 
@@ -165,7 +208,7 @@ void Transform::setMatrix(const Matrix4& matrix) {
  */
 Transform Transform::inverse() const {
     Transform result;
-    result.setMatrix(glm::inverse(matrix_));
+    result.setAffine(matrix_.inverse());
     return result;
 }
 
@@ -180,9 +223,7 @@ Transform Transform::inverse() const {
  * @return The transformed point in global coordinates
  */
 Vector2 Transform::transformPoint(const Vector2& point) const {
-    Vector4 homogeneous(point, 0.0F, 1.0F);
-    Vector4 transformed = matrix_ * homogeneous;
-    return {transformed};
+    return matrix_.transformPoint(point);
 }
 
 /**
@@ -196,10 +237,7 @@ Vector2 Transform::transformPoint(const Vector2& point) const {
  * @return The transformed point in local coordinates
  */
 Vector2 Transform::inverseTransformPoint(const Vector2& point) const {
-    Matrix4 inverseMatrix = glm::inverse(matrix_);
-    Vector4 homogeneous(point, 0.0F, 1.0F);
-    Vector4 transformed = inverseMatrix * homogeneous;
-    return {transformed};
+    return matrix_.inverseTransformPoint(point);
 }
 
 /**
@@ -218,8 +256,7 @@ Vector2 Transform::inverseTransformPoint(const Vector2& point) const {
  */
 Transform Transform::combine(const Transform& parent, const Transform& child) {
     Transform result;
-    result.matrix_ = parent.matrix_ * child.matrix_;
-    result.setMatrix(result.matrix_);
+    result.setAffine(parent.matrix_ * child.matrix_);
     return result;
 }
 
@@ -228,7 +265,8 @@ Transform Transform::combine(const Transform& parent, const Transform& child) {
  *
  * Linearly interpolates each component of the transform:
  * - Position is interpolated using linear interpolation
- * - Rotation is interpolated using linear interpolation of angles
+ * - Rotation is interpolated using normalized lerp of the unit complex
+ *   numbers, following the shorter arc
  * - Scale is interpolated using linear interpolation
  *
  * @param transform1 The first transform
@@ -237,10 +275,13 @@ Transform Transform::combine(const Transform& parent, const Transform& child) {
  * @return A new Transform representing the interpolated transformation
  */
 Transform Transform::interpolate(const Transform& start, const Transform& end, float factor) {
+    start.ensureDecomposed();
+    end.ensureDecomposed();
+
     Transform result;
-    result.position_ = glm::mix(start.position_, end.position_, factor);
-    result.rotation_ = scene_graph::wrapAngle(glm::mix(
-        scene_graph::wrapAngle(start.rotation_), scene_graph::wrapAngle(end.rotation_), factor));
+    result.setPosition(glm::mix(start.getPosition(), end.getPosition(), factor));
+    result.rotation_ = Rotation2::nlerp(start.rotation_, end.rotation_, factor);
+    result.rotationDegreesValid_ = false;
     result.scale_ = glm::mix(start.scale_, end.scale_, factor);
     result.updateMatrix();
     return result;
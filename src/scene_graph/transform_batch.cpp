@@ -0,0 +1,355 @@
+#include "scene_graph/transform_batch.h"
+
+#include <algorithm>
+
+#include "scene_graph/node.h"
+#include "scene_graph/task_scheduler.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SCENE_GRAPH_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace scene_graph {
+
+void AffineBatch::clear() {
+    a.clear();
+    b.clear();
+    c.clear();
+    d.clear();
+    tx.clear();
+    ty.clear();
+}
+
+void AffineBatch::resize(std::size_t count) {
+    a.resize(count);
+    b.resize(count);
+    c.resize(count);
+    d.resize(count);
+    tx.resize(count);
+    ty.resize(count);
+}
+
+void AffineBatch::set(std::size_t index, const Affine2& matrix) {
+    a[index] = matrix.a;
+    b[index] = matrix.b;
+    c[index] = matrix.c;
+    d[index] = matrix.d;
+    tx[index] = matrix.tx;
+    ty[index] = matrix.ty;
+}
+
+void AffineBatch::push_back(const Affine2& matrix) {
+    a.push_back(matrix.a);
+    b.push_back(matrix.b);
+    c.push_back(matrix.c);
+    d.push_back(matrix.d);
+    tx.push_back(matrix.tx);
+    ty.push_back(matrix.ty);
+}
+
+Affine2 AffineBatch::get(std::size_t index) const {
+    return {a[index], b[index], c[index], d[index], tx[index], ty[index]};
+}
+
+namespace {
+
+/**
+ * @brief Reference kernel, also used for the tail of the SIMD kernels.
+ *
+ * Goes through operator*(Affine2, Affine2) so it matches Transform::combine
+ * exactly.
+ */
+void composeScalar(const AffineBatch& parents, const AffineBatch& locals, AffineBatch& out,
+                   std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        out.set(i, parents.get(i) * locals.get(i));
+    }
+}
+
+#ifdef SCENE_GRAPH_X86_SIMD
+
+// The SIMD kernels evaluate each element as (p0 * l0 + p1 * l1) [+ p2] with
+// separate multiplies and adds, exactly like operator*. FMA is deliberately
+// not enabled, as fusing would change the rounding.
+
+__attribute__((target("sse2"))) void composeSse2(const AffineBatch& parents,
+                                                 const AffineBatch& locals, AffineBatch& out,
+                                                 std::size_t count) {
+    const std::size_t kWidth = 4;
+    std::size_t i = 0;
+    for (; i + kWidth <= count; i += kWidth) {
+        const __m128 pa = _mm_loadu_ps(&parents.a[i]);
+        const __m128 pb = _mm_loadu_ps(&parents.b[i]);
+        const __m128 pc = _mm_loadu_ps(&parents.c[i]);
+        const __m128 pd = _mm_loadu_ps(&parents.d[i]);
+        const __m128 la = _mm_loadu_ps(&locals.a[i]);
+        const __m128 lb = _mm_loadu_ps(&locals.b[i]);
+        const __m128 lc = _mm_loadu_ps(&locals.c[i]);
+        const __m128 ld = _mm_loadu_ps(&locals.d[i]);
+        const __m128 ltx = _mm_loadu_ps(&locals.tx[i]);
+        const __m128 lty = _mm_loadu_ps(&locals.ty[i]);
+
+        _mm_storeu_ps(&out.a[i], _mm_add_ps(_mm_mul_ps(pa, la), _mm_mul_ps(pc, lb)));
+        _mm_storeu_ps(&out.b[i], _mm_add_ps(_mm_mul_ps(pb, la), _mm_mul_ps(pd, lb)));
+        _mm_storeu_ps(&out.c[i], _mm_add_ps(_mm_mul_ps(pa, lc), _mm_mul_ps(pc, ld)));
+        _mm_storeu_ps(&out.d[i], _mm_add_ps(_mm_mul_ps(pb, lc), _mm_mul_ps(pd, ld)));
+        _mm_storeu_ps(&out.tx[i],
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa, ltx), _mm_mul_ps(pc, lty)),
+                                 _mm_loadu_ps(&parents.tx[i])));
+        _mm_storeu_ps(&out.ty[i],
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(pb, ltx), _mm_mul_ps(pd, lty)),
+                                 _mm_loadu_ps(&parents.ty[i])));
+    }
+    composeScalar(parents, locals, out, i, count);
+}
+
+__attribute__((target("avx2"))) void composeAvx2(const AffineBatch& parents,
+                                                 const AffineBatch& locals, AffineBatch& out,
+                                                 std::size_t count) {
+    const std::size_t kWidth = 8;
+    std::size_t i = 0;
+    for (; i + kWidth <= count; i += kWidth) {
+        const __m256 pa = _mm256_loadu_ps(&parents.a[i]);
+        const __m256 pb = _mm256_loadu_ps(&parents.b[i]);
+        const __m256 pc = _mm256_loadu_ps(&parents.c[i]);
+        const __m256 pd = _mm256_loadu_ps(&parents.d[i]);
+        const __m256 la = _mm256_loadu_ps(&locals.a[i]);
+        const __m256 lb = _mm256_loadu_ps(&locals.b[i]);
+        const __m256 lc = _mm256_loadu_ps(&locals.c[i]);
+        const __m256 ld = _mm256_loadu_ps(&locals.d[i]);
+        const __m256 ltx = _mm256_loadu_ps(&locals.tx[i]);
+        const __m256 lty = _mm256_loadu_ps(&locals.ty[i]);
+
+        _mm256_storeu_ps(&out.a[i], _mm256_add_ps(_mm256_mul_ps(pa, la), _mm256_mul_ps(pc, lb)));
+        _mm256_storeu_ps(&out.b[i], _mm256_add_ps(_mm256_mul_ps(pb, la), _mm256_mul_ps(pd, lb)));
+        _mm256_storeu_ps(&out.c[i], _mm256_add_ps(_mm256_mul_ps(pa, lc), _mm256_mul_ps(pc, ld)));
+        _mm256_storeu_ps(&out.d[i], _mm256_add_ps(_mm256_mul_ps(pb, lc), _mm256_mul_ps(pd, ld)));
+        _mm256_storeu_ps(
+            &out.tx[i], _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pa, ltx), _mm256_mul_ps(pc, lty)),
+                                      _mm256_loadu_ps(&parents.tx[i])));
+        _mm256_storeu_ps(
+            &out.ty[i], _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pb, ltx), _mm256_mul_ps(pd, lty)),
+                                      _mm256_loadu_ps(&parents.ty[i])));
+    }
+    composeScalar(parents, locals, out, i, count);
+}
+
+#endif  // SCENE_GRAPH_X86_SIMD
+
+}  // namespace
+
+/**
+ * @brief Check whether the CPU we are running on can execute a SIMD level.
+ *
+ * @param level The level to check
+ * @return True if composeAffineBatch() can run at that level
+ */
+bool isSimdLevelSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+#ifdef SCENE_GRAPH_X86_SIMD
+        case SimdLevel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Pick the widest SIMD level the CPU supports.
+ *
+ * Detected once and cached.
+ *
+ * @return The level composeAffineBatch() uses by default
+ */
+SimdLevel getBestSimdLevel() {
+    static const SimdLevel kBest = []() {
+        if (isSimdLevelSupported(SimdLevel::AVX2)) {
+            return SimdLevel::AVX2;
+        }
+        if (isSimdLevelSupported(SimdLevel::SSE2)) {
+            return SimdLevel::SSE2;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return kBest;
+}
+
+void composeAffineBatch(const AffineBatch& parents, const AffineBatch& locals, AffineBatch& out,
+                        SimdLevel level) {
+    const std::size_t count = std::min(parents.size(), locals.size());
+    out.resize(count);
+
+    if (!isSimdLevelSupported(level)) {
+        level = SimdLevel::Scalar;
+    }
+
+    switch (level) {
+#ifdef SCENE_GRAPH_X86_SIMD
+        case SimdLevel::AVX2:
+            composeAvx2(parents, locals, out, count);
+            break;
+        case SimdLevel::SSE2:
+            composeSse2(parents, locals, out, count);
+            break;
+#endif
+        default:
+            composeScalar(parents, locals, out, 0, count);
+            break;
+    }
+}
+
+/**
+ * @brief Bring every cached world transform below root up to date.
+ *
+ * Clean nodes are still visited, since a clean node can have dirty
+ * descendants, but only dirty nodes are composed. Dirty nodes are composed
+ * in chunks of kChunkSize, so a chunk's nodes are still in cache when the
+ * results are written back.
+ *
+ * @param root Root of the hierarchy to update
+ */
+void WorldTransformUpdater::update(Node& root) {
+    level_.assign(1, &root);
+    updateLevels();
+}
+
+/**
+ * @brief Update several disjoint subtrees in one pass.
+ *
+ * Equivalent to calling update() on each root, but the roots' levels are
+ * walked together so the batches span subtrees.
+ *
+ * @param roots Roots of the subtrees; none may be inside another's subtree
+ */
+void WorldTransformUpdater::update(const std::vector<Node*>& roots) {
+    level_.assign(roots.begin(), roots.end());
+    updateLevels();
+}
+
+void WorldTransformUpdater::updateLevels() {
+    // The roots compose with whatever lies above them the usual way
+    for (Node* root : level_) {
+        root->getGlobalMatrix();
+    }
+
+    parents_.resize(kChunkSize);
+    locals_.resize(kChunkSize);
+
+    while (!level_.empty()) {
+        nextLevel_.clear();
+        std::size_t pending = 0;
+
+        for (Node* node : level_) {
+            const Affine2& parentWorld = node->globalMatrix_;
+            for (const auto& child : node->children_) {
+                nextLevel_.push_back(child.get());
+                if (!child->globalTransformDirty_) {
+                    continue;
+                }
+
+                // Parents belong to the previous level, so their world
+                // matrices are already up to date
+                dirtyNodes_[pending] = child.get();
+                parents_.set(pending, parentWorld);
+                locals_.set(pending, child->transform_.getAffine());
+                if (++pending == kChunkSize) {
+                    flush(pending);
+                    pending = 0;
+                }
+            }
+        }
+        flush(pending);
+
+        level_.swap(nextLevel_);
+    }
+}
+
+void WorldTransformUpdater::flush(std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    parents_.resize(count);
+    locals_.resize(count);
+    composeAffineBatch(parents_, locals_, worlds_);
+    parents_.resize(kChunkSize);
+    locals_.resize(kChunkSize);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        dirtyNodes_[i]->globalMatrix_ = worlds_.get(i);
+        dirtyNodes_[i]->globalTransformDirty_ = false;
+    }
+}
+
+void updateWorldTransforms(Node& root) {
+    WorldTransformUpdater updater;
+    updater.update(root);
+}
+
+namespace {
+
+// Subtrees below this many nodes are not worth a task of their own
+constexpr std::size_t kMinTaskNodes = 1024;
+
+/**
+ * @brief Hand the children of a large subtree out as tasks.
+ *
+ * The node itself is updated first, so every task starts below a clean
+ * parent and tasks never write to the same node.
+ */
+void splitSubtree(Node& node, std::size_t grain, TaskScheduler& scheduler) {
+    node.getGlobalMatrix();
+
+    std::vector<Node*> group;
+    std::size_t groupNodes = 0;
+    auto submitGroup = [&]() {
+        scheduler.submit([roots = std::move(group)]() {
+            thread_local WorldTransformUpdater updater;
+            updater.update(roots);
+        });
+        group.clear();
+        groupNodes = 0;
+    };
+
+    for (const auto& child : node.getChildren()) {
+        if (child->getSubtreeSize() > grain) {
+            Node* subtree = child.get();
+            scheduler.submit(
+                [subtree, grain, &scheduler]() { splitSubtree(*subtree, grain, scheduler); });
+            continue;
+        }
+
+        group.push_back(child.get());
+        groupNodes += child->getSubtreeSize();
+        if (groupNodes >= grain) {
+            submitGroup();
+        }
+    }
+    if (!group.empty()) {
+        submitGroup();
+    }
+}
+
+}  // namespace
+
+void updateWorldTransforms(Node& root, TaskScheduler& scheduler) {
+    // Aim for a few tasks per thread so stealing can even out the load
+    const std::size_t kTasksPerThread = 4;
+    const std::size_t grain = std::max(
+        kMinTaskNodes, root.getSubtreeSize() / (scheduler.getThreadCount() * kTasksPerThread));
+
+    if (scheduler.getThreadCount() == 1 || root.getSubtreeSize() <= grain) {
+        updateWorldTransforms(root);
+        return;
+    }
+
+    splitSubtree(root, grain, scheduler);
+    scheduler.wait();
+}
+
+}  // namespace scene_graph
@@ -5,10 +5,26 @@
 
 #include "scene_graph/node.h"
 #include "scene_graph/shape.h"
+#include "scene_graph/task_scheduler.h"
 #include "types.h"
 #include "visualization/renderer.h"
 namespace visualization {
 
+namespace {
+
+// Runs of the root's children per thread, so uneven subtrees balance out
+constexpr std::size_t kChunksPerThread = 4;
+// Runs smaller than this many nodes cost more to schedule than to record
+constexpr std::size_t kMinChunkNodes = 256;
+
+void accumulate(RenderStats& total, const RenderStats& stats) {
+    total.drawn += stats.drawn;
+    total.culled += stats.culled;
+    total.culledSubtrees += stats.culledSubtrees;
+}
+
+}  // namespace
+
 Canvas::Canvas() : renderer_(nullptr), root_(nullptr), selectedNode_(nullptr) {
 }
 
@@ -25,6 +41,7 @@ bool Canvas::initialize(const std::shared_ptr<Renderer>& renderer) {
 
 void Canvas::setRoot(const std::shared_ptr<scene_graph::Node>& root) {
     root_ = root;
+    hitTestBvhStale_ = true;
 }
 
 std::shared_ptr<scene_graph::Node> Canvas::getRoot() const {
@@ -33,16 +50,20 @@ std::shared_ptr<scene_graph::Node> Canvas::getRoot() const {
 
 void Canvas::addShape(const std::shared_ptr<scene_graph::Shape>& shape) {
     shapes_.push_back(shape);
+    hitTestBvhStale_ = true;
 }
 
 void Canvas::removeShape(const std::shared_ptr<scene_graph::Shape>& shape) {
     shapes_.erase(std::remove(shapes_.begin(), shapes_.end(), shape), shapes_.end());
+    hitTestBvhStale_ = true;
 }
 
 void Canvas::clear() {
     root_ = nullptr;
     selectedNode_ = nullptr;
     shapes_.clear();
+    hitTestBvh_.clear();
+    hitTestBvhStale_ = true;
 }
 
 void Canvas::selectNode(const std::shared_ptr<scene_graph::Node>& node) {
@@ -61,51 +82,157 @@ void Canvas::render() {
         return;
     }
     renderer_->beginFrame();
+    viewBounds_ = renderer_->getViewBounds();
+    renderStats_ = RenderStats();
+    shapeBatch_.clear();
 
-    // Render the scene graph starting from the root
-    if (root_) {
+    // Bring all world transforms up to date in one batched pass, so drawing
+    // only reads cached transforms. Parallel recording updates its share of
+    // the scene graph in each task instead
+    const bool parallel = scheduler_ && scheduler_->getThreadCount() > 1;
+    if (root_ && !parallel) {
+        transformUpdater_.update(*root_);
+    }
+    for (const auto& shape : shapes_) {
+        transformUpdater_.update(*shape);
+    }
+
+    // Gather the scene graph starting from the root
+    if (root_ && parallel) {
+        recordParallel(*root_);
+    } else if (root_) {
         renderNode(root_);
     }
 
-    // Render any standalone shapes
+    // Gather any standalone shapes, drawn over the scene graph
     for (const auto& shape : shapes_) {
-        renderer_->renderShape(*shape);
+        if (viewBounds_.intersects(shape->getWorldBounds())) {
+            shapeBatch_.add(*shape, shape->getColor());
+            ++renderStats_.drawn;
+        } else {
+            ++renderStats_.culled;
+        }
     }
 
+    // Draw everything gathered with a handful of instanced draw calls
+    shapeBatch_.build();
+    renderer_->renderShapes(shapeBatch_);
+
     renderer_->endFrame();
 }
 
+/**
+ * @brief Gather a node and its subtree for drawing, skipping what is out of
+ * view.
+ *
+ * A subtree whose bounds miss the view is skipped with one test; inside a
+ * visible subtree each shape is still tested on its own bounds before it is
+ * added to the frame's shape batch.
+ *
+ * @param node The node to render.
+ */
 void Canvas::renderNode(const std::shared_ptr<scene_graph::Node>& node) {
-    // If node is a shape, render it
-    auto shape = std::dynamic_pointer_cast<scene_graph::Shape>(node);
-    if (shape) {
-        // Highlight selected node with a different color
-        Vector4 originalColor;
-        bool isSelected = (selectedNode_ == node);
-
-        if (isSelected) {
-            originalColor = shape->getColor();
-            // Adjust color to indicate selection (e.g., add a yellow tint)
-            Vector4 highlightColor(constants::colors::NODE_SELECTED[0],
-                                   constants::colors::NODE_SELECTED[1],
-                                   constants::colors::NODE_SELECTED[2], originalColor.a);
-            shape->setColor(highlightColor);
-        }
+    gatherNode(*node, shapeBatch_, renderStats_);
+}
+
+/**
+ * @brief Record the scene graph with the root's children split across the
+ * scheduler's threads.
+ *
+ * The children are grouped into contiguous runs of roughly equal node
+ * counts, a few per thread. Each task brings its run's world transforms up
+ * to date and gathers its shapes into a batch of its own; the batches are
+ * appended in child order, so the frame is the same as one recorded on a
+ * single thread. The root's subtree is not culled as a whole, only each
+ * child's.
+ *
+ * @param root The root node, recorded on the calling thread
+ */
+void Canvas::recordParallel(scene_graph::Node& root) {
+    // Tasks compose below the root, so it must be clean before they start
+    root.getGlobalMatrix();
+    gatherShape(root, shapeBatch_, renderStats_);
 
-        renderer_->renderShape(*shape);
+    const std::size_t chunkTarget = scheduler_->getThreadCount() * kChunksPerThread;
+    const std::size_t grain = std::max(kMinChunkNodes, root.getSubtreeSize() / chunkTarget);
 
-        // Restore original color if changed
-        if (isSelected) {
-            shape->setColor(originalColor);
+    std::size_t chunkCount = 0;
+    std::size_t chunkNodes = 0;
+    for (const auto& child : root.getChildren()) {
+        if (chunkNodes == 0) {
+            if (chunkCount == recordChunks_.size()) {
+                recordChunks_.emplace_back();
+            }
+            recordChunks_[chunkCount++].roots.clear();
         }
+        recordChunks_[chunkCount - 1].roots.push_back(child.get());
+        chunkNodes += child->getSubtreeSize();
+        if (chunkNodes >= grain) {
+            chunkNodes = 0;
+        }
+    }
+
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        RecordChunk& chunk = recordChunks_[i];
+        chunk.batch.clear();
+        chunk.stats = RenderStats();
+        scheduler_->submit([this, &chunk]() {
+            thread_local scene_graph::WorldTransformUpdater updater;
+            updater.update(chunk.roots);
+            for (const scene_graph::Node* node : chunk.roots) {
+                gatherNode(*node, chunk.batch, chunk.stats);
+            }
+        });
+    }
+    scheduler_->wait();
+
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        shapeBatch_.append(recordChunks_[i].batch);
+        accumulate(renderStats_, recordChunks_[i].stats);
+    }
+}
+
+// Only reads the scene graph and the canvas, so disjoint subtrees can be
+// gathered concurrently into separate batches
+void Canvas::gatherNode(const scene_graph::Node& node, ShapeBatch& batch,
+                        RenderStats& stats) const {
+    if (!viewBounds_.intersects(node.getSubtreeBounds())) {
+        stats.culled += node.getSubtreeSize();
+        ++stats.culledSubtrees;
+        return;
     }
 
+    gatherShape(node, batch, stats);
+
     // Recursively render all children
-    for (const auto& child : node->getChildren()) {
-        renderNode(child);
+    for (const auto& child : node.getChildren()) {
+        gatherNode(*child, batch, stats);
     }
 }
 
+// Add the node on its own if it is a visible shape
+void Canvas::gatherShape(const scene_graph::Node& node, ShapeBatch& batch,
+                         RenderStats& stats) const {
+    const auto* shape = dynamic_cast<const scene_graph::Shape*>(&node);
+    if (!shape) {
+        return;
+    }
+    if (!viewBounds_.intersects(shape->getWorldBounds())) {
+        ++stats.culled;
+        return;
+    }
+
+    // Highlight selected node with a different color, keeping its alpha
+    Vector4 color = shape->getColor();
+    if (selectedNode_.get() == &node) {
+        color = Vector4(constants::colors::NODE_SELECTED[0], constants::colors::NODE_SELECTED[1],
+                        constants::colors::NODE_SELECTED[2], color.a);
+    }
+
+    batch.add(*shape, color);
+    ++stats.drawn;
+}
+
 /**
  * @brief Hit test the canvas to determine which node is at a specific point.
  *
@@ -113,34 +240,77 @@ void Canvas::renderNode(const std::shared_ptr<scene_graph::Node>& node) {
  * determines which object or node is at a certain position. For instance,
  * what's under a mouse cursor
  *
+ * Standalone shapes win over the scene graph, later standalone shapes over
+ * earlier ones, and within the graph a node wins over its children and later
+ * children over earlier ones. The query runs against a BVH over the shapes'
+ * world bounds, so only shapes near the position are tested.
+ *
  * @param position The position to hit test.
  * @return The node at the position, or nullptr if no node is at the position.
  */
 std::shared_ptr<scene_graph::Node> Canvas::hitTest(const Vector2& position) const {
-    // first check against single shapes
-    for (auto iterator = shapes_.rbegin(); iterator != shapes_.rend(); iterator++) {
-        auto shape = *iterator;
-        if (shape->containsPoint(position)) {
-            return shape;
+    updateHitTestBvh();
+    scene_graph::Shape* hit = hitTestBvh_.hitTest(position);
+    return hit ? hit->shared_from_this() : nullptr;
+}
+
+/**
+ * @brief Bring the hit test BVH up to date with the scene.
+ *
+ * The tree is rebuilt when shapes were added, removed or reordered. When
+ * shapes merely moved or resized, only their leaves and the ancestors of
+ * those are refit; nothing at all is done while the scene is unchanged.
+ */
+void Canvas::updateHitTestBvh() const {
+    const std::uint64_t hierarchyRevision = scene_graph::Node::getHierarchyRevision();
+    const std::uint64_t boundsRevision = scene_graph::Node::getSceneBoundsRevision();
+
+    if (hitTestBvhStale_ || hierarchyRevision != hitTestHierarchyRevision_) {
+        std::vector<scene_graph::Shape*> shapes;
+        for (auto iterator = shapes_.rbegin(); iterator != shapes_.rend(); ++iterator) {
+            shapes.push_back(iterator->get());
+        }
+        if (root_) {
+            collectHitOrder(*root_, shapes);
         }
+        hitTestBvh_.build(shapes);
+    } else if (boundsRevision != hitTestBoundsRevision_) {
+        hitTestBvh_.refit();
     }
 
-    // If not found in standalone shapes, check the scene graph
-    if (root_) {
-        return hitTestRecursive(root_, position);
+    hitTestBvhStale_ = false;
+    hitTestHierarchyRevision_ = hierarchyRevision;
+    hitTestBoundsRevision_ = boundsRevision;
+}
+
+/**
+ * @brief Append the shapes of a subtree in the order hitTestRecursive()
+ * would test them.
+ */
+void Canvas::collectHitOrder(scene_graph::Node& node, std::vector<scene_graph::Shape*>& shapes) {
+    if (auto* shape = dynamic_cast<scene_graph::Shape*>(&node)) {
+        shapes.push_back(shape);
     }
 
-    return nullptr;
+    const auto& children = node.getChildren();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        collectHitOrder(**it, shapes);
+    }
 }
 
 std::shared_ptr<scene_graph::Node> Canvas::hitTestRecursive(
     const std::shared_ptr<scene_graph::Node>& node, const Vector2& position) const {
+    // Nothing below this node reaches the position
+    if (!node->getSubtreeBounds().contains(position)) {
+        return nullptr;
+    }
+
     // check against shapes
-    auto shape = std::dynamic_pointer_cast<scene_graph::Shape>(node);
+    const auto* shape = dynamic_cast<const scene_graph::Shape*>(node.get());
 
     if (shape) {
         if (shape->containsPoint(position)) {
-            return shape;
+            return node;
         }
     }
 
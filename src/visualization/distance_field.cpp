@@ -0,0 +1,71 @@
+#include "visualization/distance_field.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace visualization {
+
+/**
+ * @brief Build a signed distance field from a coverage bitmap.
+ *
+ * Pixels with at least half coverage are inside. Each field pixel stores the
+ * distance from its center to the nearest pixel on the other side, less half
+ * a pixel so the outline falls between the two, found by searching the
+ * spread window around it. Glyph bitmaps are small, so the search is cheap
+ * next to rasterizing them.
+ *
+ * @param coverage The bitmap, one byte per pixel
+ * @param width Bitmap width in pixels
+ * @param height Bitmap height in pixels
+ * @param pitch Bytes from one bitmap row to the next
+ * @param spread Distance in pixels the field covers on either side
+ * @return The field, width + 2 * spread by height + 2 * spread pixels; empty
+ * for an empty bitmap
+ */
+DistanceField makeDistanceField(const unsigned char* coverage, int width, int height, int pitch,
+                                int spread) {
+    DistanceField field;
+    if (width <= 0 || height <= 0) {
+        return field;
+    }
+
+    spread = std::max(spread, 1);
+    field.width = width + 2 * spread;
+    field.height = height + 2 * spread;
+    field.pixels.resize(static_cast<std::size_t>(field.width) * field.height);
+
+    // Padding is outside
+    auto inside = [&](int x, int y) {
+        return x >= 0 && y >= 0 && x < width && y < height &&
+               coverage[static_cast<std::ptrdiff_t>(y) * pitch + x] >= 128;
+    };
+
+    const float maxDistance = static_cast<float>(spread);
+    for (int y = 0; y < field.height; ++y) {
+        for (int x = 0; x < field.width; ++x) {
+            const int bitmapX = x - spread;
+            const int bitmapY = y - spread;
+            const bool isInside = inside(bitmapX, bitmapY);
+
+            float nearest = maxDistance + 0.5f;
+            for (int dy = -spread; dy <= spread; ++dy) {
+                for (int dx = -spread; dx <= spread; ++dx) {
+                    if (inside(bitmapX + dx, bitmapY + dy) != isInside) {
+                        const auto squared = static_cast<float>(dx * dx + dy * dy);
+                        nearest = std::min(nearest, std::sqrt(squared));
+                    }
+                }
+            }
+
+            const float distance = std::min(nearest - 0.5f, maxDistance);
+            const float signedDistance = isInside ? distance : -distance;
+            const float value = kDistanceFieldEdge + signedDistance / maxDistance * 127.0f;
+            field.pixels[static_cast<std::size_t>(y) * field.width + x] =
+                static_cast<unsigned char>(std::clamp(std::lround(value), 0L, 255L));
+        }
+    }
+    return field;
+}
+
+}  // namespace visualization
@@ -0,0 +1,259 @@
+#include "visualization/font_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace visualization {
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'G', 'A', 'T', 'L', 'A', 'S', '\0'};
+// Bump whenever the layout below or the glyph rasterization changes
+constexpr std::uint32_t kVersion = 2;
+
+// Followed by the font path, the glyphs and the atlas pixels
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t pathLength;
+    std::int64_t modifiedTime;
+    std::int32_t pixelSize;
+    std::int32_t atlasWidth;
+    std::int32_t atlasHeight;
+    std::int32_t shelfX;
+    std::int32_t shelfY;
+    std::int32_t shelfHeight;
+    std::uint32_t glyphCount;
+    std::uint32_t distanceField;
+};
+
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+static_assert(std::is_trivially_copyable_v<CachedGlyph>);
+
+std::filesystem::path cacheDirectory() {
+#if defined(_WIN32)
+    if (const char* localAppData = std::getenv("LOCALAPPDATA")) {
+        return std::filesystem::path(localAppData) / "scene_graphs";
+    }
+#else
+    if (const char* xdgCache = std::getenv("XDG_CACHE_HOME"); xdgCache && *xdgCache) {
+        return std::filesystem::path(xdgCache) / "scene_graphs";
+    }
+    if (const char* home = std::getenv("HOME"); home && *home) {
+        return std::filesystem::path(home) / ".cache" / "scene_graphs";
+    }
+#endif
+    return {};
+}
+
+}  // namespace
+
+std::optional<FontCacheKey> makeFontCacheKey(const std::string& fontPath, int pixelSize) {
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(fontPath, error);
+    if (error) {
+        return std::nullopt;
+    }
+    return FontCacheKey{fontPath, static_cast<std::int64_t>(modified.time_since_epoch().count()),
+                        pixelSize};
+}
+
+std::string getFontCachePath(const FontCacheKey& key) {
+    const std::filesystem::path directory = cacheDirectory();
+    if (directory.empty()) {
+        return {};
+    }
+
+    // The key is checked against the file's header, so a collision only
+    // costs a rebuild
+    std::ostringstream name;
+    name << "font-" << std::hex << std::hash<std::string>()(key.fontPath) << '-' << std::dec
+         << key.pixelSize << ".atlas";
+    return (directory / name.str()).string();
+}
+
+/**
+ * @brief Save an atlas and its glyphs for the next run.
+ *
+ * The file is written next to its final name and renamed over it, so a
+ * reader never sees it half written.
+ *
+ * @return false if the file could not be written
+ */
+bool writeFontCache(const std::string& path, const FontCacheKey& key, const GlyphAtlas& atlas,
+                    const std::vector<CachedGlyph>& glyphs) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    if (error) {
+        std::cerr << "Could not create font cache directory for " << path << ": "
+                  << error.message() << std::endl;
+        return false;
+    }
+
+    const GlyphAtlas::PackState state = atlas.getPackState();
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.pathLength = static_cast<std::uint32_t>(key.fontPath.size());
+    header.modifiedTime = key.modifiedTime;
+    header.pixelSize = key.pixelSize;
+    header.atlasWidth = atlas.getWidth();
+    header.atlasHeight = state.height;
+    header.shelfX = state.shelfX;
+    header.shelfY = state.shelfY;
+    header.shelfHeight = state.shelfHeight;
+    header.glyphCount = static_cast<std::uint32_t>(glyphs.size());
+    header.distanceField = key.distanceField ? 1 : 0;
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(key.fontPath.data(), static_cast<std::streamsize>(key.fontPath.size()));
+        file.write(reinterpret_cast<const char*>(glyphs.data()),
+                   static_cast<std::streamsize>(glyphs.size() * sizeof(CachedGlyph)));
+        file.write(reinterpret_cast<const char*>(atlas.getPixels().data()),
+                   static_cast<std::streamsize>(atlas.getPixels().size()));
+        if (!file) {
+            std::cerr << "Could not write font cache " << temporary << std::endl;
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::cerr << "Could not replace font cache " << path << ": " << error.message()
+                  << std::endl;
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Map a cache file and check it against a key.
+ *
+ * Every size in the header is checked against the file's size before
+ * anything past the header is read, and the packing state and every glyph
+ * against the atlas they describe.
+ */
+std::unique_ptr<FontCacheFile> FontCacheFile::open(const std::string& path,
+                                                   const FontCacheKey& key) {
+    std::unique_ptr<FontCacheFile> cache(new FontCacheFile());
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    cache->contents_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = cache->contents_.data();
+    size = cache->contents_.size();
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return nullptr;
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+        close(descriptor);
+        return nullptr;
+    }
+    size = static_cast<std::size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    cache->mapping_ = mapping;
+    cache->mappingSize_ = size;
+    data = static_cast<const unsigned char*>(mapping);
+#endif
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        return nullptr;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.modifiedTime != key.modifiedTime || header.pixelSize != key.pixelSize ||
+        header.pathLength != key.fontPath.size() ||
+        header.distanceField != (key.distanceField ? 1U : 0U) || header.atlasWidth <= 0 ||
+        header.atlasHeight <= 0) {
+        return nullptr;
+    }
+    // The shelf being packed must lie inside the saved atlas
+    if (header.shelfX < 0 || header.shelfX > header.atlasWidth || header.shelfY < 0 ||
+        header.shelfHeight < 0 || header.shelfHeight > header.atlasHeight - header.shelfY) {
+        return nullptr;
+    }
+
+    const std::size_t glyphBytes = std::size_t{header.glyphCount} * sizeof(CachedGlyph);
+    const std::size_t pixelBytes =
+        static_cast<std::size_t>(header.atlasWidth) * static_cast<std::size_t>(header.atlasHeight);
+    if (size != sizeof(header) + header.pathLength + glyphBytes + pixelBytes) {
+        return nullptr;
+    }
+
+    const unsigned char* cursor = data + sizeof(header);
+    if (std::memcmp(cursor, key.fontPath.data(), header.pathLength) != 0) {
+        return nullptr;
+    }
+    cursor += header.pathLength;
+
+    cache->glyphs_.resize(header.glyphCount);
+    std::memcpy(cache->glyphs_.data(), cursor, glyphBytes);
+    cursor += glyphBytes;
+
+    // Every glyph must lie inside the atlas, and each code point appear once
+    std::vector<std::uint32_t> codePoints;
+    codePoints.reserve(cache->glyphs_.size());
+    for (const CachedGlyph& glyph : cache->glyphs_) {
+        if (glyph.width < 0 || glyph.height < 0 || glyph.atlasX < 0 || glyph.atlasY < 0 ||
+            glyph.width > header.atlasWidth - glyph.atlasX ||
+            glyph.height > header.atlasHeight - glyph.atlasY) {
+            return nullptr;
+        }
+        codePoints.push_back(glyph.codePoint);
+    }
+    std::sort(codePoints.begin(), codePoints.end());
+    if (std::adjacent_find(codePoints.begin(), codePoints.end()) != codePoints.end()) {
+        return nullptr;
+    }
+
+    cache->atlasWidth_ = header.atlasWidth;
+    // The height is the one the pixel size was checked against
+    cache->packState_ = {header.atlasHeight, header.shelfX, header.shelfY, header.shelfHeight};
+    cache->pixels_ = cursor;
+    return cache;
+}
+
+FontCacheFile::~FontCacheFile() {
+#if !defined(_WIN32)
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+#endif
+}
+
+}  // namespace visualization
@@ -3,14 +3,73 @@
 #include <GL/glew.h>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "constants.h"
+#include "visualization/distance_field.h"
+#include "visualization/font_cache.h"
 
 namespace visualization {
 
+namespace {
+
+// The first shelves hold the 24px ASCII set; the atlas grows for the rest
+constexpr int kAtlasWidth = 512;
+constexpr int kAtlasInitialHeight = 128;
+constexpr int kAtlasMaxHeight = 4096;
+
+// Code points below this are looked up in a flat table
+constexpr char32_t kAsciiCount = 128;
+
+// Distance fields are rasterized larger, so they hold detail for scaling up
+int rasterSize(GlyphMode mode) {
+    return mode == GlyphMode::DistanceField ? constants::TEXT_DISTANCE_FIELD_FONT_SIZE
+                                            : constants::TEXT_FONT_SIZE;
+}
+
+enum class GlyphState : std::uint8_t { Unloaded, Loaded, Missing };
+
+struct GlyphSlot {
+    GlyphState state = GlyphState::Unloaded;
+    Character character{};
+};
+
+}  // namespace
+
 struct FontManager::Impl {
     RenderMode renderMode = RenderMode::Normal;
+    GlyphMode glyphMode = GlyphMode::Bitmap;
     bool initialized = false;
-    std::map<char, Character> characters;
+
+    // The font in use and its atlas cache key; empty without one
+    std::string fontPath;
+    std::optional<FontCacheKey> cacheKey;
+
+    // Kept open so glyphs can be rasterized when first drawn; opened late
+    // when the atlas came from the cache
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+    bool faceFailed = false;
+    // Without a face every character is this one square
+    std::optional<Character> fallback;
+
+    std::array<GlyphSlot, kAsciiCount> ascii{};
+    std::unordered_map<char32_t, GlyphSlot> glyphs;
+    std::size_t glyphCount = 0;
+    std::size_t savedGlyphCount = 0;  // Glyphs in the atlas cache file
+
+    GlyphAtlas atlas{kAtlasWidth, kAtlasInitialHeight, kAtlasMaxHeight};
+    unsigned int atlasTexture = 0;
+    int textureHeight = 0;  // Rows allocated for atlasTexture
+    // Atlas rows changed since the last upload, as [dirtyTop, dirtyBottom)
+    int dirtyTop = 0;
+    int dirtyBottom = 0;
 };
 
 FontManager::FontManager() : impl_(std::make_unique<Impl>()) {
@@ -20,6 +79,26 @@ FontManager::~FontManager() {
     cleanup();
 }
 
+/**
+ * @brief Choose how glyphs are rasterized.
+ *
+ * The atlas, its cache and the face's pixel size all depend on the mode,
+ * so it is ignored once the fonts are loaded.
+ */
+void FontManager::setGlyphMode(GlyphMode mode) {
+    if (impl_->initialized) {
+        if (mode != impl_->glyphMode) {
+            std::cerr << "Glyph mode must be set before FontManager::initialize()" << std::endl;
+        }
+        return;
+    }
+    impl_->glyphMode = mode;
+}
+
+GlyphMode FontManager::getGlyphMode() const {
+    return impl_->glyphMode;
+}
+
 bool FontManager::initialize(RenderMode mode) {
     impl_->renderMode = mode;
 
@@ -28,6 +107,14 @@ bool FontManager::initialize(RenderMode mode) {
         return true;
     }
 
+    // Storage is allocated when the first glyphs are uploaded
+    glGenTextures(1, &impl_->atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, impl_->atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
     // Load fonts
     if (!loadSystemFonts()) {
         std::cerr << "Failed to load any system fonts. Creating fallback font." << std::endl;
@@ -39,84 +126,49 @@ bool FontManager::initialize(RenderMode mode) {
 }
 
 void FontManager::cleanup() {
-    if (impl_->renderMode == RenderMode::Headless) {
-        impl_->characters.clear();
-        impl_->initialized = false;
-        return;
-    }
+    saveAtlasCache();
 
-    // Delete all character textures
-    for (auto& pair : impl_->characters) {
-        glDeleteTextures(1, &pair.second.textureID);
+    if (impl_->renderMode != RenderMode::Headless && impl_->atlasTexture != 0) {
+        glDeleteTextures(1, &impl_->atlasTexture);
+    }
+    if (impl_->face) {
+        FT_Done_Face(impl_->face);
+    }
+    if (impl_->library) {
+        FT_Done_FreeType(impl_->library);
     }
 
-    impl_->characters.clear();
+    impl_->library = nullptr;
+    impl_->face = nullptr;
+    impl_->faceFailed = false;
+    impl_->fontPath.clear();
+    impl_->cacheKey.reset();
+    impl_->fallback.reset();
+    impl_->ascii.fill(GlyphSlot());
+    impl_->glyphs.clear();
+    impl_->glyphCount = 0;
+    impl_->savedGlyphCount = 0;
+    impl_->atlasTexture = 0;
+    impl_->textureHeight = 0;
+    impl_->dirtyTop = 0;
+    impl_->dirtyBottom = 0;
+    impl_->atlas.clear();
     impl_->initialized = false;
 }
 
+/**
+ * @brief Load the first system font that is installed.
+ *
+ * A font with a valid atlas cache from an earlier run is restored from it
+ * without starting FreeType, which is only opened once text needs a glyph
+ * the cache does not have.
+ */
 bool FontManager::loadSystemFonts() {
     // Skip actual font loading in headless mode
     if (impl_->renderMode == RenderMode::Headless) {
         return true;
     }
 
-    // Initialize FreeType
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft)) {
-        std::cerr << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-        return false;
-    }
-
-    // Load font
-    FT_Face face;
-    if (!loadFonts(ft, face)) {
-        FT_Done_FreeType(ft);
-        return false;
-    }
-
-    // Set font size
-    FT_Set_Pixel_Sizes(face, 0, 24);  // Using 24 as a reasonable default size
-
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    // Load first 128 ASCII characters
-    for (unsigned char c = 0; c < 128; c++) {
-        // Load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cerr << "ERROR::FREETYPE: Failed to load Glyph for character " << c << std::endl;
-            continue;
-        }
-
-        // Generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows,
-                     0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Store character
-        Character character = {texture,
-                               glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                               glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                               static_cast<unsigned int>(face->glyph->advance.x)};
-        impl_->characters.insert(std::pair<char, Character>(c, character));
-    }
-
-    // Clean up FreeType resources
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-
-    return true;
-}
-
-bool FontManager::loadFonts(FT_Library ft, FT_Face& face) {
 // Platform-specific font paths
 #if defined(__APPLE__)
     const char* fontPaths[] = {
@@ -133,67 +185,314 @@ bool FontManager::loadFonts(FT_Library ft, FT_Face& face) {
 
     // Try loading fonts in order until one succeeds
     for (int i = 0; i < numPaths; i++) {
+        std::optional<FontCacheKey> key =
+            makeFontCacheKey(fontPaths[i], rasterSize(impl_->glyphMode));
+        if (!key) {
+            continue;  // Not installed
+        }
+        key->distanceField = impl_->glyphMode == GlyphMode::DistanceField;
+
         std::cout << "Trying to load font: " << fontPaths[i] << std::endl;
-        if (FT_New_Face(ft, fontPaths[i], 0, &face) == 0) {
+        if (loadAtlasCache(*key)) {
+            std::cout << "Loaded cached glyph atlas for font: " << fontPaths[i] << std::endl;
+        } else if (openFace(fontPaths[i])) {
             std::cout << "Successfully loaded font: " << fontPaths[i] << std::endl;
-            return true;
+        } else {
+            continue;
         }
+
+        // Nothing is rasterized yet; glyphs load as text using them is laid out
+        impl_->fontPath = fontPaths[i];
+        impl_->cacheKey = std::move(key);
+        return true;
     }
 
     std::cerr << "ERROR::FREETYPE: Failed to load any font" << std::endl;
     return false;
 }
 
+bool FontManager::openFace(const std::string& path) {
+    if (!impl_->library && FT_Init_FreeType(&impl_->library)) {
+        std::cerr << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        impl_->library = nullptr;
+        return false;
+    }
+    if (FT_New_Face(impl_->library, path.c_str(), 0, &impl_->face) != 0) {
+        impl_->face = nullptr;
+        return false;
+    }
+
+    FT_Set_Pixel_Sizes(impl_->face, 0, rasterSize(impl_->glyphMode));
+    return true;
+}
+
+/**
+ * @brief Restore the atlas and glyphs an earlier run saved for a font.
+ *
+ * The atlas pixels are copied from the mapped file; the texture is created
+ * from them in one upload by the first syncAtlasTexture().
+ *
+ * @return false if there is no valid cache for the font as it is now
+ */
+bool FontManager::loadAtlasCache(const FontCacheKey& key) {
+    const std::string path = getFontCachePath(key);
+    if (path.empty()) {
+        return false;
+    }
+
+    std::unique_ptr<FontCacheFile> cache = FontCacheFile::open(path, key);
+    if (!cache || cache->getAtlasWidth() != impl_->atlas.getWidth() ||
+        !impl_->atlas.restore(cache->getPackState(), cache->getPixels())) {
+        return false;
+    }
+
+    for (const CachedGlyph& glyph : cache->getGlyphs()) {
+        const char32_t codePoint = glyph.codePoint;
+        GlyphSlot& slot =
+            codePoint < kAsciiCount ? impl_->ascii[codePoint] : impl_->glyphs[codePoint];
+        slot.state = GlyphState::Loaded;
+        slot.character = {impl_->atlasTexture,
+                          glm::ivec2(glyph.width, glyph.height),
+                          glm::ivec2(glyph.bearingX, glyph.bearingY),
+                          glyph.advance,
+                          glm::vec2(glyph.atlasX, glyph.atlasY),
+                          glm::vec2(glyph.atlasX + glyph.width, glyph.atlasY + glyph.height)};
+    }
+    impl_->glyphCount = cache->getGlyphs().size();
+    impl_->savedGlyphCount = impl_->glyphCount;
+    return true;
+}
+
+/**
+ * @brief Save the atlas for the next run if glyphs were added to it.
+ */
+void FontManager::saveAtlasCache() {
+    if (!impl_->cacheKey || impl_->glyphCount == impl_->savedGlyphCount) {
+        return;
+    }
+    const std::string path = getFontCachePath(*impl_->cacheKey);
+    if (path.empty()) {
+        return;
+    }
+
+    std::vector<CachedGlyph> glyphs;
+    glyphs.reserve(impl_->glyphCount);
+    auto add = [&glyphs](char32_t codePoint, const GlyphSlot& slot) {
+        if (slot.state != GlyphState::Loaded) {
+            return;
+        }
+        const Character& character = slot.character;
+        glyphs.push_back({static_cast<std::uint32_t>(codePoint), character.size.x,
+                          character.size.y, character.bearing.x, character.bearing.y,
+                          character.advance, static_cast<std::int32_t>(character.atlasMin.x),
+                          static_cast<std::int32_t>(character.atlasMin.y)});
+    };
+    for (char32_t codePoint = 0; codePoint < kAsciiCount; ++codePoint) {
+        add(codePoint, impl_->ascii[codePoint]);
+    }
+    for (const auto& [codePoint, slot] : impl_->glyphs) {
+        add(codePoint, slot);
+    }
+
+    if (writeFontCache(path, *impl_->cacheKey, impl_->atlas, glyphs)) {
+        impl_->savedGlyphCount = impl_->glyphCount;
+    }
+}
+
 void FontManager::createFallbackFont() {
     // Skip in headless mode
     if (impl_->renderMode == RenderMode::Headless) {
         return;
     }
 
-    // Create a simple fallback character - just a square for each character
-    for (unsigned char c = 0; c < 128; c++) {
-        // Create a minimal character entry with a tiny texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+    // Every character is the same small white square, stored once; solid
+    // white is inside in a distance field too, so it serves both modes
+    const int side = static_cast<int>(8 / getGlyphScale());
+    std::vector<unsigned char> buffer(static_cast<std::size_t>(side) * side, 255);
+    Character character;
+    // Advance is one square, shifted by 6 bits - FreeType format
+    if (addGlyph(side, side, buffer.data(), side, glm::ivec2(0, side),
+                 static_cast<unsigned int>(side) << 6, character)) {
+        impl_->fallback = character;
+    }
+}
 
-        // Create a small 8x8 white square
-        unsigned char buffer[64];
-        std::fill_n(buffer, 64, 255);  // Fill with white
+/**
+ * @brief Rasterize a glyph of the open face into the atlas.
+ *
+ * Code points the face has no glyph for get its missing-glyph box. In
+ * distance field mode the bitmap is converted to a field, which is larger
+ * by the spread on every side, and the bearing moves out to match.
+ *
+ * @return false if FreeType fails or the atlas cannot grow to fit it
+ */
+bool FontManager::loadGlyph(char32_t codePoint, Character& character) {
+    // A font restored from its cache is opened for the first glyph the
+    // cache did not have
+    if (!impl_->face) {
+        if (impl_->faceFailed || !openFace(impl_->fontPath)) {
+            if (!impl_->faceFailed) {
+                std::cerr << "ERROR::FREETYPE: Failed to open font " << impl_->fontPath
+                          << std::endl;
+            }
+            impl_->faceFailed = true;
+            return false;
+        }
+    }
 
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, 8, 8, 0, GL_RED, GL_UNSIGNED_BYTE, buffer);
+    FT_Face face = impl_->face;
+    if (FT_Load_Char(face, codePoint, FT_LOAD_RENDER)) {
+        std::cerr << "ERROR::FREETYPE: Failed to load Glyph for code point U+" << std::hex
+                  << static_cast<std::uint32_t>(codePoint) << std::dec << std::endl;
+        return false;
+    }
 
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+    int width = static_cast<int>(bitmap.width);
+    int height = static_cast<int>(bitmap.rows);
+    const unsigned char* pixels = bitmap.buffer;
+    int pitch = bitmap.pitch;
+    glm::ivec2 bearing(face->glyph->bitmap_left, face->glyph->bitmap_top);
+
+    DistanceField field;
+    if (impl_->glyphMode == GlyphMode::DistanceField) {
+        const int spread = constants::TEXT_DISTANCE_FIELD_SPREAD;
+        field = makeDistanceField(pixels, width, height, pitch, spread);
+        width = field.width;
+        height = field.height;
+        pixels = field.pixels.data();
+        pitch = field.width;
+        bearing = glm::ivec2(bearing.x - spread, bearing.y + spread);
+    }
 
-        // Store character with minimal dimensions
-        Character character = {
-            texture, glm::ivec2(8, 8),  // Size
-            glm::ivec2(0, 8),           // Bearing
-            8 << 6                      // Advance (8 pixels, shifted by 6 bits - FreeType format)
-        };
+    if (!addGlyph(width, height, pixels, pitch, bearing,
+                  static_cast<unsigned int>(face->glyph->advance.x), character)) {
+        std::cerr << "Glyph atlas full, skipping code point U+" << std::hex
+                  << static_cast<std::uint32_t>(codePoint) << std::dec << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Copy a glyph's bitmap into the atlas and fill in its metrics.
+ *
+ * The rows it lands on are uploaded by the next syncAtlasTexture().
+ *
+ * @return false if the atlas has no room left for it
+ */
+bool FontManager::addGlyph(int width, int height, const unsigned char* pixels, int pitch,
+                           const glm::ivec2& bearing, unsigned int advance,
+                           Character& character) {
+    std::optional<AtlasRegion> region = impl_->atlas.insert(width, height, pixels, pitch);
+    if (!region) {
+        return false;
+    }
 
-        impl_->characters.insert(std::pair<char, Character>(c, character));
+    if (region->height > 0) {
+        const int bottom = region->y + region->height;
+        if (impl_->dirtyTop == impl_->dirtyBottom) {
+            impl_->dirtyTop = region->y;
+            impl_->dirtyBottom = bottom;
+        } else {
+            impl_->dirtyTop = std::min(impl_->dirtyTop, region->y);
+            impl_->dirtyBottom = std::max(impl_->dirtyBottom, bottom);
+        }
     }
+
+    character = {impl_->atlasTexture,
+                 glm::ivec2(width, height),
+                 bearing,
+                 advance,
+                 glm::vec2(region->x, region->y),
+                 glm::vec2(region->x + width, region->y + height)};
+    ++impl_->glyphCount;
+    return true;
 }
 
-const Character* FontManager::getCharacter(char c) const {
-    auto it = impl_->characters.find(c);
-    if (it != impl_->characters.end()) {
-        return &it->second;
+/**
+ * @brief Upload what changed in the atlas since the last call.
+ *
+ * New glyphs only rewrite the rows they were packed into. When the atlas
+ * has grown the texture is reallocated at the new height; glyph coordinates
+ * are in pixels, so text laid out before stays valid.
+ */
+void FontManager::syncAtlasTexture() {
+    if (impl_->renderMode == RenderMode::Headless || impl_->atlasTexture == 0) {
+        return;
+    }
+
+    const GlyphAtlas& atlas = impl_->atlas;
+    const bool resized = impl_->textureHeight != atlas.getHeight();
+    if (!resized && impl_->dirtyTop == impl_->dirtyBottom) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, impl_->atlasTexture);
+    // Rows are tightly packed single bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (resized) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, atlas.getWidth(), atlas.getHeight(), 0, GL_RED,
+                     GL_UNSIGNED_BYTE, atlas.getPixels().data());
+        impl_->textureHeight = atlas.getHeight();
+    } else {
+        const unsigned char* rows =
+            atlas.getPixels().data() + static_cast<std::size_t>(impl_->dirtyTop) * atlas.getWidth();
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, impl_->dirtyTop, atlas.getWidth(),
+                        impl_->dirtyBottom - impl_->dirtyTop, GL_RED, GL_UNSIGNED_BYTE, rows);
     }
-    return nullptr;
+    impl_->dirtyTop = 0;
+    impl_->dirtyBottom = 0;
+}
+
+/**
+ * @brief Look up a glyph, rasterizing it on first use.
+ *
+ * ASCII is a flat table lookup; other code points go through a hash map.
+ * Glyphs that fail to load are remembered and not retried.
+ *
+ * @return The glyph, or nullptr if the font cannot draw it
+ */
+const Character* FontManager::getCharacter(char32_t codePoint) {
+    if (impl_->fallback) {
+        return &*impl_->fallback;
+    }
+    if (impl_->fontPath.empty()) {
+        return nullptr;
+    }
+
+    GlyphSlot& slot =
+        codePoint < kAsciiCount ? impl_->ascii[codePoint] : impl_->glyphs[codePoint];
+    if (slot.state == GlyphState::Unloaded) {
+        slot.state =
+            loadGlyph(codePoint, slot.character) ? GlyphState::Loaded : GlyphState::Missing;
+    }
+    return slot.state == GlyphState::Loaded ? &slot.character : nullptr;
+}
+
+bool FontManager::hasCharacter(char32_t codePoint) {
+    return getCharacter(codePoint) != nullptr;
+}
+
+std::size_t FontManager::getGlyphCount() const {
+    return impl_->glyphCount;
+}
+
+float FontManager::getGlyphScale() const {
+    return static_cast<float>(constants::TEXT_FONT_SIZE) /
+           static_cast<float>(rasterSize(impl_->glyphMode));
+}
+
+unsigned int FontManager::getAtlasTexture() const {
+    return impl_->atlasTexture;
 }
 
-bool FontManager::hasCharacter(char c) const {
-    return impl_->characters.find(c) != impl_->characters.end();
+const GlyphAtlas& FontManager::getAtlas() const {
+    return impl_->atlas;
 }
 
 bool FontManager::isInitialized() const {
     return impl_->initialized;
 }
 
-}  // namespace visualization
\ No newline at end of file
+}  // namespace visualization
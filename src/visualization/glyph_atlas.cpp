@@ -0,0 +1,92 @@
+#include "visualization/glyph_atlas.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace visualization {
+
+GlyphAtlas::GlyphAtlas(int width, int height, int maxHeight)
+    : width_(width),
+      height_(height),
+      initialHeight_(height),
+      maxHeight_(std::max(height, maxHeight)),
+      pixels_(static_cast<std::size_t>(width) * height, 0) {
+}
+
+/**
+ * @brief Copy a bitmap into the next free spot.
+ *
+ * @param width Bitmap width in pixels
+ * @param height Bitmap height in pixels
+ * @param pixels The bitmap, one byte per pixel
+ * @param pitch Bytes from one bitmap row to the next
+ * @return Where the bitmap was put, or nothing if the atlas is full and
+ * cannot grow enough
+ */
+std::optional<AtlasRegion> GlyphAtlas::insert(int width, int height, const unsigned char* pixels,
+                                              int pitch) {
+    if (width <= 0 || height <= 0) {
+        return AtlasRegion{0, 0, 0, 0};
+    }
+
+    // Open a new shelf below the current one when the bitmap does not fit;
+    // a bitmap that fits nowhere leaves the shelves as they were
+    int x = shelfX_;
+    int y = shelfY_;
+    int shelfHeight = shelfHeight_;
+    if (x + width + kPadding > width_) {
+        x = kPadding;
+        y += shelfHeight + kPadding;
+        shelfHeight = 0;
+    }
+    const int bottom = y + height + kPadding;
+    if (x + width + kPadding > width_ || bottom > maxHeight_) {
+        return std::nullopt;
+    }
+    if (bottom > height_) {
+        // Rows are appended, so existing pixels stay where they are
+        while (height_ < bottom) {
+            height_ = std::min(std::max(2 * height_, 1), maxHeight_);
+        }
+        pixels_.resize(static_cast<std::size_t>(width_) * height_, 0);
+    }
+
+    const AtlasRegion region{x, y, width, height};
+    for (int row = 0; row < height; ++row) {
+        const unsigned char* source = pixels + static_cast<std::ptrdiff_t>(row) * pitch;
+        std::copy(source, source + width,
+                  pixels_.begin() + static_cast<std::ptrdiff_t>(region.y + row) * width_ +
+                      region.x);
+    }
+
+    shelfX_ = x + width + kPadding;
+    shelfY_ = y;
+    shelfHeight_ = std::max(shelfHeight, height);
+    return region;
+}
+
+void GlyphAtlas::clear() {
+    height_ = initialHeight_;
+    pixels_.assign(static_cast<std::size_t>(width_) * height_, 0);
+    shelfX_ = kPadding;
+    shelfY_ = kPadding;
+    shelfHeight_ = 0;
+}
+
+bool GlyphAtlas::restore(const PackState& state, const unsigned char* pixels) {
+    // Written so that no sum can overflow on a damaged state
+    if (state.height <= 0 || state.height > maxHeight_ || state.shelfX < 0 ||
+        state.shelfX > width_ || state.shelfY < 0 || state.shelfHeight < 0 ||
+        state.shelfHeight > state.height - state.shelfY) {
+        return false;
+    }
+
+    height_ = state.height;
+    pixels_.assign(pixels, pixels + static_cast<std::size_t>(width_) * height_);
+    shelfX_ = state.shelfX;
+    shelfY_ = state.shelfY;
+    shelfHeight_ = state.shelfHeight;
+    return true;
+}
+
+}  // namespace visualization
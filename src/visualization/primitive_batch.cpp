@@ -0,0 +1,53 @@
+#include "visualization/primitive_batch.h"
+
+#include <cmath>
+
+namespace visualization {
+
+/**
+ * @brief Add an axis-aligned rectangle.
+ *
+ * @param x Left edge
+ * @param y Bottom edge
+ */
+void PrimitiveBatch::addRectangle(float x, float y, float width, float height,
+                                  const Vector4& color) {
+    addQuad(Vector2(x, y), Vector2(x + width, y), Vector2(x + width, y + height),
+            Vector2(x, y + height), color);
+}
+
+/**
+ * @brief Add a line as a quad of the given thickness centered on it.
+ *
+ * The quad's corners are offset along the line's normal, so no angle is
+ * computed. A zero-length line has no direction and adds nothing.
+ */
+void PrimitiveBatch::addLine(float x1, float y1, float x2, float y2, const Vector4& color,
+                             float thickness) {
+    const float dx = x2 - x1;
+    const float dy = y2 - y1;
+    const float lengthSquared = dx * dx + dy * dy;
+    if (lengthSquared <= 0.0F) {
+        return;
+    }
+
+    const float scale = 0.5F * thickness / std::sqrt(lengthSquared);
+    const Vector2 offset(-dy * scale, dx * scale);
+    const Vector2 start(x1, y1);
+    const Vector2 end(x2, y2);
+    addQuad(start - offset, end - offset, end + offset, start + offset, color);
+}
+
+void PrimitiveBatch::clear() {
+    vertices_.clear();
+}
+
+void PrimitiveBatch::addQuad(const Vector2& p0, const Vector2& p1, const Vector2& p2,
+                             const Vector2& p3, const Vector4& color) {
+    const Vector2* corners[kVerticesPerQuad] = {&p0, &p1, &p2, &p2, &p3, &p0};
+    for (const Vector2* corner : corners) {
+        vertices_.push_back({corner->x, corner->y, color.r, color.g, color.b, color.a});
+    }
+}
+
+}  // namespace visualization
@@ -0,0 +1,199 @@
+#include "visualization/render_queue.h"
+
+#include <algorithm>
+
+namespace visualization {
+
+namespace {
+
+constexpr int kLayerShift = 60;
+constexpr int kBatchShift = 48;
+constexpr int kTranslucentShift = 47;
+
+// Opaque: shader, vertex array, depth
+constexpr int kOpaqueShaderShift = 39;
+constexpr int kOpaqueVertexArrayShift = 31;
+constexpr int kOpaqueDepthShift = 7;
+
+// Translucent: depth, shader, vertex array
+constexpr int kTranslucentDepthShift = 23;
+constexpr int kTranslucentShaderShift = 15;
+constexpr int kTranslucentVertexArrayShift = 7;
+
+// The program a command type draws with; the backend maps these to handles
+std::uint8_t shaderOf(RenderCommandType type) {
+    return static_cast<std::uint8_t>(type);
+}
+
+// The vertex array a command draws from
+std::uint8_t vertexArrayOf(RenderCommandType type, ShapeKind kind) {
+    switch (type) {
+        case RenderCommandType::Shapes:
+            return static_cast<std::uint8_t>(kind);
+        case RenderCommandType::Primitives:
+            return 2;
+        case RenderCommandType::Text:
+            return 3;
+    }
+    return 0;
+}
+
+}  // namespace
+
+namespace sort_key {
+
+std::uint64_t make(RenderLayer layer, std::uint32_t batch, bool translucent, std::uint8_t shader,
+                   std::uint8_t vertexArray, std::uint32_t depth) {
+    const std::uint64_t clamped = std::min(depth, kMaxDepth);
+    std::uint64_t key = static_cast<std::uint64_t>(layer) << kLayerShift;
+    key |= static_cast<std::uint64_t>(std::min(batch, kMaxBatch)) << kBatchShift;
+    if (translucent) {
+        key |= 1ULL << kTranslucentShift;
+        key |= clamped << kTranslucentDepthShift;
+        key |= static_cast<std::uint64_t>(shader) << kTranslucentShaderShift;
+        key |= static_cast<std::uint64_t>(vertexArray) << kTranslucentVertexArrayShift;
+    } else {
+        key |= static_cast<std::uint64_t>(shader) << kOpaqueShaderShift;
+        key |= static_cast<std::uint64_t>(vertexArray) << kOpaqueVertexArrayShift;
+        key |= clamped << kOpaqueDepthShift;
+    }
+    return key;
+}
+
+RenderLayer layer(std::uint64_t key) {
+    return static_cast<RenderLayer>(key >> kLayerShift);
+}
+
+std::uint32_t batch(std::uint64_t key) {
+    return static_cast<std::uint32_t>(key >> kBatchShift) & kMaxBatch;
+}
+
+bool isTranslucent(std::uint64_t key) {
+    return ((key >> kTranslucentShift) & 1U) != 0;
+}
+
+std::uint8_t shader(std::uint64_t key) {
+    return static_cast<std::uint8_t>(
+        key >> (isTranslucent(key) ? kTranslucentShaderShift : kOpaqueShaderShift));
+}
+
+std::uint8_t vertexArray(std::uint64_t key) {
+    return static_cast<std::uint8_t>(
+        key >> (isTranslucent(key) ? kTranslucentVertexArrayShift : kOpaqueVertexArrayShift));
+}
+
+std::uint32_t depth(std::uint64_t key) {
+    const int shift = isTranslucent(key) ? kTranslucentDepthShift : kOpaqueDepthShift;
+    return static_cast<std::uint32_t>(key >> shift) & kMaxDepth;
+}
+
+}  // namespace sort_key
+
+void RenderQueue::clear() {
+    commands_.clear();
+    instances_.clear();
+    primitives_.clear();
+    textRuns_.clear();
+    text_.clear();
+    sequence_ = 0;
+    batch_ = 0;
+}
+
+/**
+ * @brief Record the instanced draws of a built batch.
+ *
+ * The instances are copied, so the batch may change once this returns.
+ * Their depths already encode the batch's draw order, so the opaque ranges
+ * get depth 0 and sort by state; translucent runs keep their order. The
+ * batch gets its own batch number, so it draws after everything recorded
+ * before it.
+ */
+void RenderQueue::addShapes(const ShapeBatch& batch, RenderLayer layer) {
+    ++batch_;
+    const auto base = static_cast<std::uint32_t>(instances_.size());
+    instances_.insert(instances_.end(), batch.getInstances().begin(),
+                      batch.getInstances().end());
+
+    for (const ShapeBatch::Range& range : batch.getRanges()) {
+        RenderCommand command;
+        command.type = RenderCommandType::Shapes;
+        command.kind = range.kind;
+        command.first = base + range.first;
+        command.count = range.count;
+        command.key =
+            sort_key::make(layer, batch_, range.translucent, shaderOf(command.type),
+                           vertexArrayOf(command.type, range.kind),
+                           range.translucent ? nextDepth() : 0);
+        commands_.push_back(command);
+    }
+}
+
+void RenderQueue::addRectangle(RenderLayer layer, float x, float y, float width, float height,
+                               const Vector4& color) {
+    const std::size_t quadsBefore = primitives_.getQuadCount();
+    primitives_.addRectangle(x, y, width, height, color);
+    recordPrimitives(layer, quadsBefore);
+}
+
+void RenderQueue::addLine(RenderLayer layer, float x1, float y1, float x2, float y2,
+                          const Vector4& color, float thickness) {
+    const std::size_t quadsBefore = primitives_.getQuadCount();
+    primitives_.addLine(x1, y1, x2, y2, color, thickness);
+    recordPrimitives(layer, quadsBefore);
+}
+
+void RenderQueue::addText(RenderLayer layer, std::string_view text, float x, float y,
+                          const Vector4& color) {
+    textRuns_.push_back({static_cast<std::uint32_t>(text_.size()),
+                         static_cast<std::uint32_t>(text.size()), x, y, color});
+    text_.append(text);
+
+    if (!commands_.empty()) {
+        RenderCommand& last = commands_.back();
+        if (last.type == RenderCommandType::Text && sort_key::layer(last.key) == layer) {
+            ++last.count;
+            return;
+        }
+    }
+
+    RenderCommand command;
+    command.type = RenderCommandType::Text;
+    command.first = static_cast<std::uint32_t>(textRuns_.size() - 1);
+    command.count = 1;
+    command.key = sort_key::make(layer, batch_, true, shaderOf(command.type),
+                                 vertexArrayOf(command.type, command.kind), nextDepth());
+    commands_.push_back(command);
+}
+
+void RenderQueue::sort() {
+    std::stable_sort(commands_.begin(), commands_.end(),
+                     [](const RenderCommand& a, const RenderCommand& b) { return a.key < b.key; });
+}
+
+void RenderQueue::recordPrimitives(RenderLayer layer, std::size_t quadsBefore) {
+    const std::size_t added = primitives_.getQuadCount() - quadsBefore;
+    if (added == 0) {
+        return;
+    }
+    if (!commands_.empty()) {
+        RenderCommand& last = commands_.back();
+        if (last.type == RenderCommandType::Primitives && sort_key::layer(last.key) == layer) {
+            last.count += static_cast<std::uint32_t>(added);
+            return;
+        }
+    }
+
+    RenderCommand command;
+    command.type = RenderCommandType::Primitives;
+    command.first = static_cast<std::uint32_t>(quadsBefore);
+    command.count = static_cast<std::uint32_t>(added);
+    command.key = sort_key::make(layer, batch_, true, shaderOf(command.type),
+                                 vertexArrayOf(command.type, command.kind), nextDepth());
+    commands_.push_back(command);
+}
+
+std::uint32_t RenderQueue::nextDepth() {
+    return std::min(sequence_++, sort_key::kMaxDepth);
+}
+
+}  // namespace visualization
@@ -0,0 +1,143 @@
+#include "visualization/render_state.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace visualization {
+
+bool RenderState::change(unsigned int& shadow, unsigned int value) {
+    if (shadow == value) {
+        ++stats_.skipped;
+        return false;
+    }
+    shadow = value;
+    ++stats_.issued;
+    return !headless_;
+}
+
+void RenderState::useProgram(unsigned int program) {
+    if (change(program_, program)) {
+        glUseProgram(program);
+    }
+}
+
+void RenderState::bindVertexArray(unsigned int vertexArray) {
+    if (change(vertexArray_, vertexArray)) {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+void RenderState::bindArrayBuffer(unsigned int buffer) {
+    if (change(arrayBuffer_, buffer)) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    }
+}
+
+void RenderState::activeTexture(unsigned int unit) {
+    if (change(activeUnit_, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+/**
+ * @brief Bind a 2D texture to the active unit.
+ *
+ * With the active unit unknown the binding cannot be shadowed, so it always
+ * reaches GL; set the unit first with activeTexture().
+ */
+void RenderState::bindTexture2D(unsigned int texture) {
+    if (activeUnit_ >= kMaxTextureUnits) {
+        ++stats_.issued;
+        if (!headless_) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+        return;
+    }
+    if (change(textures_[activeUnit_], texture)) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+}
+
+void RenderState::setBlend(bool enabled) {
+    if (change(blend_, enabled ? 1U : 0U)) {
+        if (enabled) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+}
+
+void RenderState::setBlendFunc(unsigned int sourceFactor, unsigned int destinationFactor) {
+    if (blendSource_ == sourceFactor && blendDestination_ == destinationFactor) {
+        ++stats_.skipped;
+        return;
+    }
+    blendSource_ = sourceFactor;
+    blendDestination_ = destinationFactor;
+    ++stats_.issued;
+    if (!headless_) {
+        glBlendFunc(sourceFactor, destinationFactor);
+    }
+}
+
+void RenderState::setDepthTest(bool enabled) {
+    if (change(depthTest_, enabled ? 1U : 0U)) {
+        if (enabled) {
+            glEnable(GL_DEPTH_TEST);
+        } else {
+            glDisable(GL_DEPTH_TEST);
+        }
+    }
+}
+
+void RenderState::setDepthFunc(unsigned int func) {
+    if (change(depthFunc_, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void RenderState::onProgramDeleted(unsigned int program) {
+    // A deleted program stays in use until another one is, but its name may
+    // be recycled
+    if (program_ == program) {
+        program_ = kUnknown;
+    }
+}
+
+void RenderState::onVertexArrayDeleted(unsigned int vertexArray) {
+    if (vertexArray_ == vertexArray) {
+        vertexArray_ = 0;
+    }
+}
+
+void RenderState::onBufferDeleted(unsigned int buffer) {
+    if (arrayBuffer_ == buffer) {
+        arrayBuffer_ = 0;
+    }
+}
+
+void RenderState::onTextureDeleted(unsigned int texture) {
+    for (unsigned int& bound : textures_) {
+        if (bound == texture) {
+            bound = 0;
+        }
+    }
+}
+
+void RenderState::invalidate() {
+    program_ = kUnknown;
+    vertexArray_ = kUnknown;
+    arrayBuffer_ = kUnknown;
+    activeUnit_ = kUnknown;
+    std::fill(std::begin(textures_), std::end(textures_), kUnknown);
+    blend_ = kUnknown;
+    blendSource_ = kUnknown;
+    blendDestination_ = kUnknown;
+    depthTest_ = kUnknown;
+    depthFunc_ = kUnknown;
+}
+
+}  // namespace visualization
@@ -10,7 +10,8 @@ namespace visualization {
 using std::make_shared;
 
 Renderer::Renderer()
-    : shaderManager_(make_shared<ShaderManager>()),
+    : renderState_(make_shared<RenderState>()),
+      shaderManager_(make_shared<ShaderManager>(renderState_)),
       fontManager_(make_shared<FontManager>()),
       mode_(RenderMode::Normal) {
     // Create dependent renderers
@@ -52,6 +53,9 @@ bool Renderer::initialize() {
     }
     std::cout << "ShaderManager initialized successfully" << std::endl;
 
+    // Must precede the programs the renderers link
+    shaderManager_->setUniformBlockBinding(kCameraBlockName, kCameraBindingPoint);
+
     if (!fontManager_->initialize(mode_)) {
         std::cerr << "Failed to initialize FontManager" << std::endl;
         return false;
@@ -81,16 +85,28 @@ bool Renderer::initialize() {
     // Set initial viewport
     shapeRenderer_->setViewport(viewportWidth_, viewportHeight_);
 
-    // Enable alpha blending for semi-transparent shapes
     if (mode_ != RenderMode::Headless) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glGenBuffers(1, &cameraBuffer_);
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer_);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniforms), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, kCameraBindingPoint, cameraBuffer_);
     }
+    updateCameraBuffer();
+
+    // Resource setup binds objects behind the state tracker's back
+    renderState_->invalidate();
+
+    // Enable alpha blending for semi-transparent shapes
+    renderState_->setBlend(true);
+    renderState_->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     return true;
 }
 
 void Renderer::cleanup() {
+    queue_.clear();
+    submitted_.clear();
+
     // Clean up components in reverse order
     if (shapeRenderer_) {
         shapeRenderer_->cleanup();
@@ -107,6 +123,15 @@ void Renderer::cleanup() {
     if (shaderManager_) {
         shaderManager_->cleanup();
     }
+
+    if (cameraBuffer_ != 0) {
+        glDeleteBuffers(1, &cameraBuffer_);
+        cameraBuffer_ = 0;
+    }
+
+    if (renderState_) {
+        renderState_->invalidate();
+    }
 }
 
 void Renderer::setHeadlessMode(bool headless) {
@@ -117,7 +142,16 @@ bool Renderer::isHeadlessMode() const {
     return mode_ == RenderMode::Headless;
 }
 
+void Renderer::setGlyphMode(GlyphMode mode) {
+    fontManager_->setGlyphMode(mode);
+}
+
 void Renderer::beginFrame() {
+    // Once per frame, so draws only set per-object data
+    updateCameraBuffer();
+    layer_ = RenderLayer::Scene;
+    submitted_.clear();
+
     if (mode_ == RenderMode::Headless) {
         return;
     }
@@ -128,6 +162,8 @@ void Renderer::beginFrame() {
 }
 
 void Renderer::endFrame() {
+    flush();
+
     if (mode_ == RenderMode::Headless) {
         return;
     }
@@ -135,42 +171,145 @@ void Renderer::endFrame() {
     glFlush();
 }
 
+/**
+ * @brief Sort and execute the commands recorded since the last flush.
+ *
+ * Happens at endFrame(); callers drawing after endFrame() flush when they
+ * are done.
+ */
+void Renderer::flush() {
+    if (queue_.empty()) {
+        return;
+    }
+    queue_.sort();
+    execute(queue_);
+    submitted_.insert(submitted_.end(), queue_.getCommands().begin(),
+                      queue_.getCommands().end());
+    queue_.clear();
+}
+
+/**
+ * @brief Draw a sorted queue.
+ *
+ * Each payload is uploaded once, then every command draws its range of it.
+ * Each shape batch is depth tested on its own, so later batches cover
+ * earlier ones. The renderers skip GL in headless mode, but still count
+ * their draws.
+ */
+void Renderer::execute(const RenderQueue& queue) {
+    if (!shapeRenderer_ || !textRenderer_) {
+        return;
+    }
+
+    shapeRenderer_->uploadPrimitives(queue.getPrimitives().getVertices());
+    if (!queue.getInstances().empty()) {
+        shapeRenderer_->uploadInstances(queue.getInstances());
+    }
+
+    // The batch whose depths the depth buffer holds; none yet
+    RenderLayer depthLayer = RenderLayer::Scene;
+    std::uint32_t depthBatch = sort_key::kMaxBatch + 1;
+    for (const RenderCommand& command : queue.getCommands()) {
+        switch (command.type) {
+            case RenderCommandType::Shapes:
+                if (sort_key::batch(command.key) != depthBatch ||
+                    sort_key::layer(command.key) != depthLayer) {
+                    depthBatch = sort_key::batch(command.key);
+                    depthLayer = sort_key::layer(command.key);
+                    shapeRenderer_->clearDepth();
+                }
+                shapeRenderer_->drawInstances(queue.getInstances(), command.kind, command.first,
+                                              command.count);
+                break;
+            case RenderCommandType::Primitives:
+                shapeRenderer_->drawPrimitives(command.first, command.count);
+                break;
+            case RenderCommandType::Text:
+                // All strings of a command go out in one draw
+                for (std::uint32_t i = command.first; i < command.first + command.count; ++i) {
+                    const TextRun& run = queue.getTextRun(i);
+                    textRenderer_->drawText(queue.getText(run), run.x, run.y, run.color);
+                }
+                renderState_->setDepthTest(false);
+                textRenderer_->flush();
+                break;
+        }
+    }
+    renderState_->setDepthTest(false);
+}
+
 void Renderer::setViewport(int width, int height) {
+    // Recorded draws belong to the old projection
+    flush();
     viewportWidth_ = width;
     viewportHeight_ = height;
 
     if (shapeRenderer_) {
         shapeRenderer_->setViewport(width, height);
     }
+    updateCameraBuffer();
 
     if (mode_ != RenderMode::Headless) {
         glViewport(0, 0, width, height);
     }
 }
 
+/**
+ * @brief Fill the camera uniform block and upload it to its buffer.
+ *
+ * Shapes use the viewport's projection; text is laid out in fixed scene
+ * units, so its projection covers the scene regardless of the viewport.
+ */
+void Renderer::updateCameraBuffer() {
+    if (shapeRenderer_) {
+        camera_.projection = shapeRenderer_->getProjectionMatrix();
+    }
+    const float halfWidth = constants::SCENE_HALF_WIDTH;
+    const float halfHeight = constants::SCENE_HALF_HEIGHT;
+    camera_.textProjection =
+        glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, -1.0f, 1.0f);
+
+    if (mode_ == RenderMode::Headless || cameraBuffer_ == 0) {
+        return;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniforms), &camera_);
+}
+
+scene_graph::Aabb Renderer::getViewBounds() const {
+    if (shapeRenderer_) {
+        return shapeRenderer_->getViewBounds();
+    }
+    return scene_graph::Aabb::infinite();
+}
+
 void Renderer::renderShape(const scene_graph::Shape& shape) {
+    // Must land on top of what was recorded before it
+    flush();
     if (shapeRenderer_) {
         shapeRenderer_->renderShape(shape);
     }
 }
 
+void Renderer::renderShapes(const ShapeBatch& batch) {
+    queue_.addShapes(batch, layer_);
+}
+
 void Renderer::drawRectangle(float x, float y, float width, float height, const Vector4& color) {
-    if (shapeRenderer_) {
-        shapeRenderer_->drawRectangle(x, y, width, height, color);
-    }
+    queue_.addRectangle(layer_, x, y, width, height, color);
 }
 
 void Renderer::drawLine(float x1, float y1, float x2, float y2, const Vector4& color,
                         float thickness) {
-    if (shapeRenderer_) {
-        shapeRenderer_->drawLine(x1, y1, x2, y2, color, thickness);
-    }
+    queue_.addLine(layer_, x1, y1, x2, y2, color, thickness);
 }
 
-void Renderer::drawText(const std::string& text, float x, float y, const Vector4& color) {
-    if (textRenderer_) {
-        textRenderer_->drawText(text, x, y, color);
-    }
+void Renderer::drawText(std::string_view text, float x, float y, const Vector4& color) {
+    queue_.addText(layer_, text, x, y, color);
+}
+
+float Renderer::measureText(std::string_view text) const {
+    return textRenderer_ ? textRenderer_->measureText(text) : 0.0f;
 }
 
 std::shared_ptr<ShapeRenderer> Renderer::getShapeRenderer() const {
@@ -181,4 +320,8 @@ std::shared_ptr<TextRenderer> Renderer::getTextRenderer() const {
     return textRenderer_;
 }
 
+std::shared_ptr<RenderState> Renderer::getRenderState() const {
+    return renderState_;
+}
+
 }  // namespace visualization
\ No newline at end of file
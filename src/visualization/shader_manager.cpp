@@ -2,21 +2,121 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace visualization {
 
+namespace {
+
+using UniformMap = std::unordered_map<std::string, int>;
+
+// Locations of all active uniforms of a linked program. Arrays are
+// registered under their plain name as well as GL's "name[0]"
+UniformMap reflectUniforms(unsigned int program) {
+    UniformMap uniforms;
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> buffer(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()),
+                           &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+
+        // Uniforms in blocks have no location of their own
+        const GLint location = glGetUniformLocation(program, name.c_str());
+        if (location < 0) {
+            continue;
+        }
+        uniforms.emplace(name, location);
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            uniforms.emplace(name.substr(0, name.size() - 3), location);
+        }
+    }
+    return uniforms;
+}
+
+}  // namespace
+
 struct ShaderManager::Impl {
     RenderMode renderMode = RenderMode::Normal;
     bool initialized = false;
+    std::shared_ptr<RenderState> renderState;
+
+    struct Program {
+        unsigned int id = 0;
+        UniformMap uniforms;
+        std::uint32_t generation = 0;
+    };
+
+    // Programs are indexed by ShaderHandle and never removed before cleanup,
+    // so handles stay valid when a program is rebuilt under the same name
+    std::vector<Program> programs;
+    std::unordered_map<std::string, std::uint32_t> programIndices;
+    // Counts every link, and is not reset by cleanup(), so an id from an
+    // earlier link never matches a later one
+    std::uint32_t nextGeneration = 0;
+
+    // Uniform block name to binding point, applied to every program linked
+    std::vector<std::pair<std::string, unsigned int>> blockBindings;
+
+    static void bindBlock(unsigned int program, const std::string& blockName,
+                          unsigned int bindingPoint) {
+        unsigned int blockIndex = glGetUniformBlockIndex(program, blockName.c_str());
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, blockIndex, bindingPoint);
+        }
+    }
+
+    void registerProgram(const std::string& name, unsigned int id, UniformMap uniforms) {
+        auto [it, inserted] =
+            programIndices.emplace(name, static_cast<std::uint32_t>(programs.size()));
+        const std::uint32_t generation = nextGeneration++;
+        if (inserted) {
+            programs.push_back({id, std::move(uniforms), generation});
+            return;
+        }
+        Program& program = programs[it->second];
+        if (program.id != 0 && renderMode != RenderMode::Headless) {
+            glDeleteProgram(program.id);
+            renderState->onProgramDeleted(program.id);
+        }
+        program = {id, std::move(uniforms), generation};
+    }
 
-    // Map of shader program names to OpenGL program IDs
-    std::unordered_map<std::string, unsigned int> shaderPrograms;
+    // Whether a uniform may be set; reports ids from an earlier link
+    bool accepts(UniformId uniform) const {
+        if (renderMode == RenderMode::Headless || !uniform.isValid()) {
+            return false;
+        }
+        if (uniform.program >= programs.size() ||
+            programs[uniform.program].generation != uniform.generation) {
+            std::cerr << "Stale uniform id; resolve it again after rebuilding its program"
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    const Program* findProgram(const std::string& name) const {
+        auto it = programIndices.find(name);
+        return it != programIndices.end() ? &programs[it->second] : nullptr;
+    }
 };
 
-ShaderManager::ShaderManager() : impl_(std::make_unique<Impl>()) {
+ShaderManager::ShaderManager(std::shared_ptr<RenderState> renderState)
+    : impl_(std::make_unique<Impl>()) {
+    impl_->renderState = std::move(renderState);
 }
 
 ShaderManager::~ShaderManager() {
@@ -25,6 +125,7 @@ ShaderManager::~ShaderManager() {
 
 bool ShaderManager::initialize(RenderMode mode) {
     impl_->renderMode = mode;
+    impl_->renderState->setHeadless(mode == RenderMode::Headless);
     impl_->initialized = true;
     return true;
 }
@@ -35,19 +136,22 @@ bool ShaderManager::isHeadlessMode() const {
 
 void ShaderManager::cleanup() {
     if (impl_->renderMode == RenderMode::Headless) {
-        impl_->shaderPrograms.clear();
+        impl_->programs.clear();
+        impl_->programIndices.clear();
         impl_->initialized = false;
         return;
     }
 
     // Delete all shader programs
-    for (auto& [name, program] : impl_->shaderPrograms) {
-        if (program != 0) {
-            glDeleteProgram(program);
+    for (const Impl::Program& program : impl_->programs) {
+        if (program.id != 0) {
+            glDeleteProgram(program.id);
+            impl_->renderState->onProgramDeleted(program.id);
         }
     }
 
-    impl_->shaderPrograms.clear();
+    impl_->programs.clear();
+    impl_->programIndices.clear();
     impl_->initialized = false;
 }
 
@@ -56,7 +160,7 @@ bool ShaderManager::createShaderProgram(const std::string& name, const std::stri
     // Skip creating shaders in headless mode
     if (impl_->renderMode == RenderMode::Headless) {
         // In headless mode, just register the name and return success
-        impl_->shaderPrograms[name] = 0;
+        impl_->registerProgram(name, 0, {});
         return true;
     }
 
@@ -119,8 +223,12 @@ bool ShaderManager::createShaderProgram(const std::string& name, const std::stri
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
-    // Store the shader program
-    impl_->shaderPrograms[name] = shaderProgram;
+    for (const auto& [blockName, bindingPoint] : impl_->blockBindings) {
+        Impl::bindBlock(shaderProgram, blockName, bindingPoint);
+    }
+
+    // Store the shader program with the locations of its uniforms
+    impl_->registerProgram(name, shaderProgram, reflectUniforms(shaderProgram));
 
     return true;
 }
@@ -147,63 +255,138 @@ bool ShaderManager::compileShader(unsigned int& shader, const std::string& sourc
     return true;
 }
 
-void ShaderManager::useShader(const std::string& name) {
-    if (impl_->renderMode == RenderMode::Headless) {
-        return;
+ShaderHandle ShaderManager::getShaderHandle(const std::string& name) const {
+    auto it = impl_->programIndices.find(name);
+    if (it == impl_->programIndices.end()) {
+        return {};
     }
+    return {it->second};
+}
+
+/**
+ * @brief Look up a uniform reflected when the program was linked.
+ *
+ * No GL query is made. Uniforms the compiler removed because they are unused
+ * yield an invalid id, which the setters ignore, as GL does for location -1.
+ */
+UniformId ShaderManager::getUniformId(ShaderHandle shader, const std::string& name) const {
+    if (!shader.isValid() || shader.index >= impl_->programs.size()) {
+        return {};
+    }
+    const Impl::Program& program = impl_->programs[shader.index];
+    auto it = program.uniforms.find(name);
+    return it != program.uniforms.end() ? UniformId{it->second, shader.index, program.generation}
+                                        : UniformId{};
+}
 
-    auto it = impl_->shaderPrograms.find(name);
-    if (it != impl_->shaderPrograms.end()) {
-        glUseProgram(it->second);
+bool ShaderManager::isCurrent(UniformId uniform) const {
+    return uniform.program < impl_->programs.size() &&
+           impl_->programs[uniform.program].generation == uniform.generation;
+}
+
+/**
+ * @brief Bind a named uniform block to a binding point in every program.
+ *
+ * Applies to the programs already linked and to any linked later. Programs
+ * without the block are left alone.
+ */
+void ShaderManager::setUniformBlockBinding(const std::string& blockName,
+                                           unsigned int bindingPoint) {
+    auto it = std::find_if(impl_->blockBindings.begin(), impl_->blockBindings.end(),
+                           [&blockName](const auto& entry) { return entry.first == blockName; });
+    if (it == impl_->blockBindings.end()) {
+        impl_->blockBindings.emplace_back(blockName, bindingPoint);
     } else {
-        std::cerr << "Shader program '" << name << "' not found!" << std::endl;
+        it->second = bindingPoint;
+    }
+
+    if (impl_->renderMode == RenderMode::Headless) {
+        return;
+    }
+    for (const Impl::Program& program : impl_->programs) {
+        if (program.id != 0) {
+            Impl::bindBlock(program.id, blockName, bindingPoint);
+        }
     }
 }
 
-void ShaderManager::setUniformMatrix4fv(const std::string& shader, const std::string& name,
-                                        const Matrix4& matrix) {
+void ShaderManager::useShader(ShaderHandle shader) {
     if (impl_->renderMode == RenderMode::Headless) {
         return;
     }
 
-    auto it = impl_->shaderPrograms.find(shader);
-    if (it != impl_->shaderPrograms.end()) {
-        unsigned int location = glGetUniformLocation(it->second, name.c_str());
-        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+    if (shader.isValid() && shader.index < impl_->programs.size()) {
+        impl_->renderState->useProgram(impl_->programs[shader.index].id);
+    } else {
+        std::cerr << "Invalid shader handle!" << std::endl;
     }
 }
 
-void ShaderManager::setUniform4f(const std::string& shader, const std::string& name,
-                                 const Vector4& vec) {
+void ShaderManager::useShader(const std::string& name) {
     if (impl_->renderMode == RenderMode::Headless) {
         return;
     }
 
-    auto it = impl_->shaderPrograms.find(shader);
-    if (it != impl_->shaderPrograms.end()) {
-        unsigned int location = glGetUniformLocation(it->second, name.c_str());
-        glUniform4f(location, vec.r, vec.g, vec.b, vec.a);
+    if (const Impl::Program* program = impl_->findProgram(name)) {
+        impl_->renderState->useProgram(program->id);
+    } else {
+        std::cerr << "Shader program '" << name << "' not found!" << std::endl;
     }
 }
 
-void ShaderManager::setUniform1f(const std::string& shader, const std::string& name, float value) {
-    if (impl_->renderMode == RenderMode::Headless) {
+void ShaderManager::setUniform(UniformId uniform, const Matrix4& matrix) {
+    if (!impl_->accepts(uniform)) {
+        return;
+    }
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+void ShaderManager::setUniform(UniformId uniform, const Vector4& vec) {
+    if (!impl_->accepts(uniform)) {
         return;
     }
+    glUniform4f(uniform.location, vec.r, vec.g, vec.b, vec.a);
+}
 
-    auto it = impl_->shaderPrograms.find(shader);
-    if (it != impl_->shaderPrograms.end()) {
-        unsigned int location = glGetUniformLocation(it->second, name.c_str());
-        glUniform1f(location, value);
+void ShaderManager::setUniform(UniformId uniform, float value) {
+    if (!impl_->accepts(uniform)) {
+        return;
     }
+    glUniform1f(uniform.location, value);
+}
+
+UniformId ShaderManager::findUniform(const std::string& shader, const std::string& name) const {
+    return getUniformId(getShaderHandle(shader), name);
+}
+
+void ShaderManager::setUniformMatrix4fv(const std::string& shader, const std::string& name,
+                                        const Matrix4& matrix) {
+    setUniform(findUniform(shader, name), matrix);
+}
+
+void ShaderManager::setUniform4f(const std::string& shader, const std::string& name,
+                                 const Vector4& vec) {
+    setUniform(findUniform(shader, name), vec);
+}
+
+void ShaderManager::setUniform1f(const std::string& shader, const std::string& name, float value) {
+    setUniform(findUniform(shader, name), value);
 }
 
 unsigned int ShaderManager::getShaderProgram(const std::string& name) const {
-    auto it = impl_->shaderPrograms.find(name);
-    if (it != impl_->shaderPrograms.end()) {
-        return it->second;
+    const Impl::Program* program = impl_->findProgram(name);
+    return program ? program->id : 0;
+}
+
+unsigned int ShaderManager::getShaderProgram(ShaderHandle shader) const {
+    if (!shader.isValid() || shader.index >= impl_->programs.size()) {
+        return 0;
     }
-    return 0;
+    return impl_->programs[shader.index].id;
+}
+
+const std::shared_ptr<RenderState>& ShaderManager::getRenderState() const {
+    return impl_->renderState;
 }
 
 bool ShaderManager::isInitialized() const {
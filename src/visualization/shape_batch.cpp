@@ -0,0 +1,103 @@
+#include "visualization/shape_batch.h"
+
+#include <scene_graph/circle.h>
+#include <scene_graph/rectangle.h>
+
+namespace visualization {
+
+void ShapeBatch::clear() {
+    items_.clear();
+    instances_.clear();
+    ranges_.clear();
+}
+
+/**
+ * @brief Describe how a shape is drawn: its geometry, its world matrix with
+ * the size folded in and its color.
+ *
+ * Reads the cached world matrix, so world transforms must be up to date.
+ */
+std::optional<ShapeBatch::Item> ShapeBatch::makeItem(const scene_graph::Shape& shape,
+                                                     const Vector4& color) {
+    const scene_graph::Affine2& worldMatrix = shape.getGlobalMatrix();
+    if (const auto* rect = dynamic_cast<const scene_graph::Rectangle*>(&shape)) {
+        return Item{&shape, ShapeKind::Rectangle, worldMatrix.scaled(rect->getSize()), color};
+    }
+    if (const auto* circle = dynamic_cast<const scene_graph::Circle*>(&shape)) {
+        const float diameter = circle->getRadius() * 2.0F;
+        return Item{&shape, ShapeKind::Circle, worldMatrix.scaled(Vector2(diameter, diameter)),
+                    color};
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Gather a shape for this frame.
+ *
+ * @param shape The shape to draw
+ * @param color The color to draw it with, which may differ from its own
+ */
+void ShapeBatch::add(const scene_graph::Shape& shape, const Vector4& color) {
+    if (auto item = makeItem(shape, color)) {
+        items_.push_back(*item);
+    }
+}
+
+void ShapeBatch::append(const ShapeBatch& other) {
+    items_.insert(items_.end(), other.items_.begin(), other.items_.end());
+}
+
+/**
+ * @brief Arrange the gathered shapes into instance ranges.
+ *
+ * Instances are laid out as all opaque rectangles, then all opaque circles,
+ * then the translucent shapes in draw order. Depths run from near 1 for the
+ * first shape to near -1 for the last, strictly decreasing, so a depth test
+ * of GL_LESS draws later shapes over earlier ones.
+ */
+void ShapeBatch::build() {
+    instances_.clear();
+    ranges_.clear();
+    instances_.reserve(items_.size());
+
+    const float depthStep = 2.0F / static_cast<float>(items_.size() + 1);
+    auto depthOf = [depthStep](std::size_t index) {
+        return 1.0F - depthStep * static_cast<float>(index + 1);
+    };
+
+    for (ShapeKind kind : {ShapeKind::Rectangle, ShapeKind::Circle}) {
+        const auto first = static_cast<std::uint32_t>(instances_.size());
+        for (std::size_t i = 0; i < items_.size(); ++i) {
+            if (items_[i].kind == kind && items_[i].color.a >= 1.0F) {
+                appendInstance(items_[i], depthOf(i));
+            }
+        }
+        const auto count = static_cast<std::uint32_t>(instances_.size()) - first;
+        if (count > 0) {
+            ranges_.push_back({kind, first, count});
+        }
+    }
+
+    const std::size_t firstTranslucentRange = ranges_.size();
+    for (std::size_t i = 0; i < items_.size(); ++i) {
+        const Item& item = items_[i];
+        if (item.color.a >= 1.0F) {
+            continue;
+        }
+        if (ranges_.size() == firstTranslucentRange || ranges_.back().kind != item.kind) {
+            ranges_.push_back(
+                {item.kind, static_cast<std::uint32_t>(instances_.size()), 0, true});
+        }
+        appendInstance(item, depthOf(i));
+        ++ranges_.back().count;
+    }
+}
+
+void ShapeBatch::appendInstance(const Item& item, float depth) {
+    const scene_graph::Affine2& m = item.matrix;
+    instances_.push_back({{m.a, m.b, m.c, m.d},
+                          {m.tx, m.ty, depth},
+                          {item.color.r, item.color.g, item.color.b, item.color.a}});
+}
+
+}  // namespace visualization
@@ -2,20 +2,75 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 
 #include "constants.h"
 namespace visualization {
 
+namespace {
+
+constexpr int kCircleSegments = 32;
+constexpr int kRectangleIndexCount = 6;
+constexpr int kCircleIndexCount = kCircleSegments * 3;
+
+int indexCount(ShapeKind kind) {
+    return kind == ShapeKind::Rectangle ? kRectangleIndexCount : kCircleIndexCount;
+}
+
+// Point the per-instance attributes of the bound VAO at the instance buffer,
+// starting at the given instance. GL 3.3 has no base instance for
+// glDrawElementsInstanced, so ranges are selected through the offset
+void setInstanceAttributes(std::size_t firstInstance) {
+    const std::size_t base = firstInstance * sizeof(ShapeInstance);
+    const auto stride = static_cast<GLsizei>(sizeof(ShapeInstance));
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(ShapeInstance, linear)));
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(ShapeInstance, translateDepth)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride,
+                          (void*)(base + offsetof(ShapeInstance, color)));
+}
+
+}  // namespace
+
 struct ShapeRenderer::Impl {
     bool initialized = false;
     unsigned int rectangleVAO = 0;
     unsigned int circleVAO = 0;
-    int viewportWidth = constants::DEFAULT_WINDOW_WIDTH;
-    int viewportHeight = constants::DEFAULT_WINDOW_HEIGHT;
+    unsigned int rectangleVBO = 0;
+    unsigned int rectangleEBO = 0;
+    unsigned int circleVBO = 0;
+    unsigned int circleEBO = 0;
+    // Viewport height over width, from the last viewport with an area
+    float aspectRatio = static_cast<float>(constants::DEFAULT_WINDOW_HEIGHT) /
+                        static_cast<float>(constants::DEFAULT_WINDOW_WIDTH);
     std::string shaderName = "shape";
+
+    // Resolved once the programs are linked, so draws pass no strings
+    ShaderHandle shapeShader;
+    UniformId shapeModel;
+    UniformId shapeColor;
+    ShaderHandle instancedShader;
+    ShaderHandle primitiveShader;
+
+    // Instanced path; the geometry buffers are shared with the VAOs above
+    bool instancingAvailable = false;
+    bool instancingEnabled = true;
+    unsigned int rectangleInstancedVAO = 0;
+    unsigned int circleInstancedVAO = 0;
+    unsigned int instanceVBO = 0;
+    std::string instancedShaderName = "shape_instanced";
+
+    // Rectangles and lines, uploaded once per flush of the render queue
+    PrimitiveStats primitiveStats;
+    unsigned int primitiveVAO = 0;
+    unsigned int primitiveVBO = 0;
+    std::size_t primitiveCapacity = 0;  // Bytes allocated for primitiveVBO
+    std::string primitiveShaderName = "primitive";
 };
 
 ShapeRenderer::ShapeRenderer(std::shared_ptr<ShaderManager> shaderManager)
@@ -33,12 +88,12 @@ bool ShapeRenderer::initialize(RenderMode mode) {
     }
 
     // Create shader program for shapes
-    const char* vertexShaderSource = R"(
-        #version 330 core
+    // The projection comes from the per-frame camera block
+    const std::string vertexShaderSource =
+        std::string("#version 330 core\n") + kCameraBlockGlsl + R"(
         layout (location = 0) in vec2 aPos;
         
         uniform mat4 model;
-        uniform mat4 projection;
         
         void main() {
             gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
@@ -61,6 +116,9 @@ bool ShapeRenderer::initialize(RenderMode mode) {
         std::cerr << "Failed to create shape shader program" << std::endl;
         return false;
     }
+    impl_->shapeShader = shaderManager_->getShaderHandle(impl_->shaderName);
+    impl_->shapeModel = shaderManager_->getUniformId(impl_->shapeShader, "model");
+    impl_->shapeColor = shaderManager_->getUniformId(impl_->shapeShader, "color");
 
     // Rectangle geometry
     float rectangleVertices[] = {
@@ -75,17 +133,16 @@ bool ShapeRenderer::initialize(RenderMode mode) {
         2, 3, 0   // second triangle
     };
 
-    unsigned int VBO, EBO;
     glGenVertexArrays(1, &impl_->rectangleVAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &impl_->rectangleVBO);
+    glGenBuffers(1, &impl_->rectangleEBO);
 
     glBindVertexArray(impl_->rectangleVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, impl_->rectangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, impl_->rectangleEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(rectangleIndices), rectangleIndices,
                  GL_STATIC_DRAW);
 
@@ -96,7 +153,7 @@ bool ShapeRenderer::initialize(RenderMode mode) {
     glBindVertexArray(0);
 
     // Circle geometry
-    const int circleSegments = 32;
+    const int circleSegments = kCircleSegments;
     float circleVertices[circleSegments * 2 + 2];
     circleVertices[0] = 0.0f;  // center x
     circleVertices[1] = 0.0f;  // center y
@@ -114,17 +171,16 @@ bool ShapeRenderer::initialize(RenderMode mode) {
         circleIndices[i * 3 + 2] = (i + 1) % circleSegments + 1;
     }
 
-    unsigned int circleVBO, circleEBO;
     glGenVertexArrays(1, &impl_->circleVAO);
-    glGenBuffers(1, &circleVBO);
-    glGenBuffers(1, &circleEBO);
+    glGenBuffers(1, &impl_->circleVBO);
+    glGenBuffers(1, &impl_->circleEBO);
 
     glBindVertexArray(impl_->circleVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, circleVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, impl_->circleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(circleVertices), circleVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, circleEBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, impl_->circleEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(circleIndices), circleIndices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
@@ -133,96 +189,207 @@ bool ShapeRenderer::initialize(RenderMode mode) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
+    if (!initializePrimitives()) {
+        std::cerr << "Failed to create primitive shader program" << std::endl;
+        return false;
+    }
+
+    // Without instancing every shape is still drawn on its own
+    impl_->instancingAvailable = initializeInstancing();
+    if (!impl_->instancingAvailable) {
+        std::cerr << "Instanced shape rendering unavailable, drawing shapes one by one"
+                  << std::endl;
+    }
+
     impl_->initialized = true;
     return true;
 }
 
-void ShapeRenderer::cleanup() {
-    if (impl_->initialized) {
-        if (impl_->rectangleVAO != 0) {
-            glDeleteVertexArrays(1, &impl_->rectangleVAO);
-            impl_->rectangleVAO = 0;
+/**
+ * @brief Create the instanced shader, the instance buffer and a VAO per
+ * geometry that combines the shared geometry with per-instance attributes.
+ *
+ * @return true if the instanced path can be used
+ */
+bool ShapeRenderer::initializeInstancing() {
+    // The sized world matrix and the draw order depth come per instance.
+    // Depth is written after the projection so it does not depend on it
+    const std::string vertexShaderSource =
+        std::string("#version 330 core\n") + kCameraBlockGlsl + R"(
+        layout (location = 0) in vec2 aPos;
+        layout (location = 1) in vec4 iLinear;
+        layout (location = 2) in vec3 iTranslateDepth;
+        layout (location = 3) in vec4 iColor;
+
+        out vec4 vColor;
+
+        void main() {
+            vec2 world = mat2(iLinear.xy, iLinear.zw) * aPos + iTranslateDepth.xy;
+            gl_Position = projection * vec4(world, 0.0, 1.0);
+            gl_Position.z = iTranslateDepth.z;
+            vColor = iColor;
         }
+    )";
+
+    const char* fragmentShaderSource = R"(
+        #version 330 core
+        in vec4 vColor;
+        out vec4 FragColor;
 
-        if (impl_->circleVAO != 0) {
-            glDeleteVertexArrays(1, &impl_->circleVAO);
-            impl_->circleVAO = 0;
+        void main() {
+            FragColor = vColor;
         }
+    )";
+
+    if (!shaderManager_->createShaderProgram(impl_->instancedShaderName, vertexShaderSource,
+                                             fragmentShaderSource)) {
+        return false;
     }
+    impl_->instancedShader = shaderManager_->getShaderHandle(impl_->instancedShaderName);
 
-    impl_->initialized = false;
-}
+    glGenBuffers(1, &impl_->instanceVBO);
 
-void ShapeRenderer::setViewport(int width, int height) {
-    impl_->viewportWidth = width;
-    impl_->viewportHeight = height;
+    auto createVAO = [this](unsigned int& vao, unsigned int vbo, unsigned int ebo) {
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+        glBindBuffer(GL_ARRAY_BUFFER, impl_->instanceVBO);
+        setInstanceAttributes(0);
+        for (unsigned int location = 1; location <= 3; ++location) {
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    };
+    createVAO(impl_->rectangleInstancedVAO, impl_->rectangleVBO, impl_->rectangleEBO);
+    createVAO(impl_->circleInstancedVAO, impl_->circleVBO, impl_->circleEBO);
+    return true;
 }
 
-void ShapeRenderer::renderShape(const scene_graph::Shape& shape) {
-    if (!impl_->initialized) {
-        std::cerr << "ShapeRenderer not initialized!" << std::endl;
-        return;
-    }
+/**
+ * @brief Create the shader and the growable vertex buffer for queued
+ * rectangles and lines, which carry their color per vertex.
+ */
+bool ShapeRenderer::initializePrimitives() {
+    const std::string vertexShaderSource =
+        std::string("#version 330 core\n") + kCameraBlockGlsl + R"(
+        layout (location = 0) in vec2 aPos;
+        layout (location = 1) in vec4 aColor;
 
-    // Skip rendering in headless mode
-    if (shaderManager_->isHeadlessMode()) {
-        return;
-    }
+        out vec4 vColor;
+
+        void main() {
+            gl_Position = projection * vec4(aPos, 0.0, 1.0);
+            vColor = aColor;
+        }
+    )";
+
+    const char* fragmentShaderSource = R"(
+        #version 330 core
+        in vec4 vColor;
+        out vec4 FragColor;
 
-    // Use the shape shader program
-    shaderManager_->useShader(impl_->shaderName);
+        void main() {
+            FragColor = vColor;
+        }
+    )";
 
-    // Create projection matrix
-    Matrix4 projection =
-        glm::ortho(-10.0f, 10.0f, -10.0f * impl_->viewportHeight / impl_->viewportWidth,
-                   10.0f * impl_->viewportHeight / impl_->viewportWidth, -1.0f, 1.0f);
+    if (!shaderManager_->createShaderProgram(impl_->primitiveShaderName, vertexShaderSource,
+                                             fragmentShaderSource)) {
+        return false;
+    }
+    impl_->primitiveShader = shaderManager_->getShaderHandle(impl_->primitiveShaderName);
 
-    // Set projection uniform
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "projection", projection);
+    glGenVertexArrays(1, &impl_->primitiveVAO);
+    glGenBuffers(1, &impl_->primitiveVBO);
 
-    // Set model matrix from the shape's transform
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "model",
-                                        shape.getGlobalTransform().getMatrix());
+    glBindVertexArray(impl_->primitiveVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, impl_->primitiveVBO);
 
-    // Set color uniform
-    shaderManager_->setUniform4f(impl_->shaderName, "color", shape.getColor());
+    const auto stride = static_cast<GLsizei>(sizeof(PrimitiveVertex));
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PrimitiveVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PrimitiveVertex, r));
+    glEnableVertexAttribArray(1);
 
-    // Draw shape based on type
-    if (const auto* rect = dynamic_cast<const scene_graph::Rectangle*>(&shape)) {
-        const Vector2& size = rect->getSize();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    return true;
+}
 
-        // Create scale matrix for size
-        Matrix4 sizeScale = glm::scale(Matrix4(1.0f), glm::vec3(size.x, size.y, 1.0f));
-        Matrix4 modelWithSize = shape.getGlobalTransform().getMatrix() * sizeScale;
+void ShapeRenderer::cleanup() {
+    if (impl_->initialized) {
+        unsigned int* vaos[] = {&impl_->rectangleVAO, &impl_->circleVAO,
+                                &impl_->rectangleInstancedVAO, &impl_->circleInstancedVAO,
+                                &impl_->primitiveVAO};
+        RenderState& state = *shaderManager_->getRenderState();
+        for (unsigned int* vao : vaos) {
+            if (*vao != 0) {
+                glDeleteVertexArrays(1, vao);
+                state.onVertexArrayDeleted(*vao);
+                *vao = 0;
+            }
+        }
 
-        // Set the combined model matrix
-        shaderManager_->setUniformMatrix4fv(impl_->shaderName, "model", modelWithSize);
+        unsigned int* buffers[] = {&impl_->rectangleVBO, &impl_->rectangleEBO, &impl_->circleVBO,
+                                   &impl_->circleEBO, &impl_->instanceVBO,
+                                   &impl_->primitiveVBO};
+        for (unsigned int* buffer : buffers) {
+            if (*buffer != 0) {
+                glDeleteBuffers(1, buffer);
+                state.onBufferDeleted(*buffer);
+                *buffer = 0;
+            }
+        }
+    }
 
-        // Draw rectangle
-        glBindVertexArray(impl_->rectangleVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    } else if (const auto* circle = dynamic_cast<const scene_graph::Circle*>(&shape)) {
-        float radius = circle->getRadius();
+    impl_->primitiveCapacity = 0;
+    impl_->instancingAvailable = false;
+    impl_->initialized = false;
+}
 
-        // Create scale matrix for radius
-        Matrix4 sizeScale =
-            glm::scale(Matrix4(1.0f), glm::vec3(radius * 2.0f, radius * 2.0f, 1.0f));
-        Matrix4 modelWithSize = shape.getGlobalTransform().getMatrix() * sizeScale;
+void ShapeRenderer::setInstancingEnabled(bool enabled) {
+    impl_->instancingEnabled = enabled;
+}
 
-        // Set the combined model matrix
-        shaderManager_->setUniformMatrix4fv(impl_->shaderName, "model", modelWithSize);
+bool ShapeRenderer::isInstancingEnabled() const {
+    return impl_->instancingEnabled && impl_->instancingAvailable;
+}
 
-        // Draw circle
-        glBindVertexArray(impl_->circleVAO);
-        glDrawElements(GL_TRIANGLES, 32 * 3, GL_UNSIGNED_INT, 0);
+void ShapeRenderer::setViewport(int width, int height) {
+    // A minimized window has an empty framebuffer; keep the last view
+    // rather than dividing by zero
+    if (width > 0 && height > 0) {
+        impl_->aspectRatio = static_cast<float>(height) / static_cast<float>(width);
     }
+}
 
-    // Unbind VAO
-    glBindVertexArray(0);
+/**
+ * @brief The world-space rectangle the projection maps onto the viewport.
+ *
+ * 20 units wide, centered on the origin, with the height following the
+ * viewport's aspect ratio. Anything outside it is not visible. An empty
+ * viewport keeps the bounds of the last one that was not.
+ */
+scene_graph::Aabb ShapeRenderer::getViewBounds() const {
+    const float halfWidth = 10.0f;
+    const float halfHeight = 10.0f * impl_->aspectRatio;
+    return scene_graph::Aabb::fromCenterExtents(Vector2(0.0f), Vector2(halfWidth, halfHeight));
+}
+
+Matrix4 ShapeRenderer::getProjectionMatrix() const {
+    const scene_graph::Aabb view = getViewBounds();
+    return glm::ortho(view.min.x, view.max.x, view.min.y, view.max.y, -1.0f, 1.0f);
 }
 
-void ShapeRenderer::drawRectangle(float x, float y, float width, float height,
-                                  const Vector4& color) {
+void ShapeRenderer::renderShape(const scene_graph::Shape& shape) {
     if (!impl_->initialized) {
         std::cerr << "ShapeRenderer not initialized!" << std::endl;
         return;
@@ -233,75 +400,151 @@ void ShapeRenderer::drawRectangle(float x, float y, float width, float height,
         return;
     }
 
-    // Use the shape shader program
-    shaderManager_->useShader(impl_->shaderName);
+    if (auto item = ShapeBatch::makeItem(shape, shape.getColor())) {
+        shaderManager_->useShader(impl_->shapeShader);
+        drawItem(*item);
+    }
+}
 
-    // Create projection matrix
-    Matrix4 projection =
-        glm::ortho(-10.0f, 10.0f, -10.0f * impl_->viewportHeight / impl_->viewportWidth,
-                   10.0f * impl_->viewportHeight / impl_->viewportWidth, -1.0f, 1.0f);
+// Per-shape path; expects the shape shader in use
+void ShapeRenderer::drawItem(const ShapeBatch::Item& item) {
+    // The 4x4 model matrix is only built here, for the upload
+    shaderManager_->setUniform(impl_->shapeModel, item.matrix.toMatrix4());
+    shaderManager_->setUniform(impl_->shapeColor, item.color);
 
-    // Set projection uniform
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "projection", projection);
+    // Consecutive shapes of one kind share the vertex array binding
+    shaderManager_->getRenderState()->bindVertexArray(
+        item.kind == ShapeKind::Rectangle ? impl_->rectangleVAO : impl_->circleVAO);
+    glDrawElements(GL_TRIANGLES, indexCount(item.kind), GL_UNSIGNED_INT, 0);
+}
 
-    // Create model matrix with translation and scale
-    Matrix4 model = Matrix4(1.0f);
-    model = glm::translate(model, glm::vec3(x + width / 2.0f, y + height / 2.0f, 0.0f));
-    model = glm::scale(model, glm::vec3(width, height, 1.0f));
+/**
+ * @brief Upload the instances the following drawInstances() calls draw
+ * from.
+ */
+void ShapeRenderer::uploadInstances(const std::vector<ShapeInstance>& instances) {
+    if (!impl_->initialized || shaderManager_->isHeadlessMode()) {
+        return;
+    }
 
-    // Set model and color uniforms
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "model", model);
-    shaderManager_->setUniform4f(impl_->shaderName, "color", color);
+    // Respecify the whole buffer every frame, so the driver can hand out
+    // fresh storage instead of waiting for last frame's draws
+    if (isInstancingEnabled()) {
+        shaderManager_->getRenderState()->bindArrayBuffer(impl_->instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(ShapeInstance),
+                     instances.data(), GL_STREAM_DRAW);
+    }
+}
 
-    // Draw rectangle
-    glBindVertexArray(impl_->rectangleVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+/**
+ * @brief Clear the depth buffer before drawing a batch's instances.
+ *
+ * Every batch spreads its depths over the whole range, so one batch must
+ * not be tested against the depths another left behind.
+ */
+void ShapeRenderer::clearDepth() {
+    if (!impl_->initialized || shaderManager_->isHeadlessMode()) {
+        return;
+    }
+    glClear(GL_DEPTH_BUFFER_BIT);
 }
 
-void ShapeRenderer::drawLine(float x1, float y1, float x2, float y2, const Vector4& color,
-                             float thickness) {
-    if (!impl_->initialized) {
-        std::cerr << "ShapeRenderer not initialized!" << std::endl;
+/**
+ * @brief Draw instances [first, first + count) of the uploaded instances,
+ * all of one kind.
+ *
+ * Later shapes have smaller depths, so with the depth test on they win
+ * wherever shapes overlap, whatever order the ranges are drawn in. The
+ * depth test stays on for the next range; drawing anything else turns it
+ * off.
+ */
+void ShapeRenderer::drawInstances(const std::vector<ShapeInstance>& instances, ShapeKind kind,
+                                  std::uint32_t first, std::uint32_t count) {
+    if (!impl_->initialized || shaderManager_->isHeadlessMode() || count == 0) {
         return;
     }
 
-    // Skip rendering in headless mode
-    if (shaderManager_->isHeadlessMode()) {
+    RenderState& state = *shaderManager_->getRenderState();
+    state.setDepthTest(true);
+    state.setDepthFunc(GL_LESS);
+
+    if (!isInstancingEnabled()) {
+        shaderManager_->useShader(impl_->shapeShader);
+        state.bindVertexArray(kind == ShapeKind::Rectangle ? impl_->rectangleVAO
+                                                           : impl_->circleVAO);
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            const ShapeInstance& instance = instances[i];
+            // The orthographic projection negates z, so this lands on the depth
+            Matrix4 model(1.0f);
+            model[0] = Vector4(instance.linear[0], instance.linear[1], 0.0f, 0.0f);
+            model[1] = Vector4(instance.linear[2], instance.linear[3], 0.0f, 0.0f);
+            model[3] = Vector4(instance.translateDepth[0], instance.translateDepth[1],
+                               -instance.translateDepth[2], 1.0f);
+            shaderManager_->setUniform(impl_->shapeModel, model);
+            shaderManager_->setUniform(
+                impl_->shapeColor, Vector4(instance.color[0], instance.color[1],
+                                           instance.color[2], instance.color[3]));
+            glDrawElements(GL_TRIANGLES, indexCount(kind), GL_UNSIGNED_INT, 0);
+        }
         return;
     }
 
-    // Calculate line length and angle
-    float dx = x2 - x1;
-    float dy = y2 - y1;
-    float length = std::sqrt(dx * dx + dy * dy);
-    float angle = std::atan2(dy, dx);
+    shaderManager_->useShader(impl_->instancedShader);
+    state.bindVertexArray(kind == ShapeKind::Rectangle ? impl_->rectangleInstancedVAO
+                                                       : impl_->circleInstancedVAO);
+    // Re-pointing the attributes reads the instance buffer binding
+    state.bindArrayBuffer(impl_->instanceVBO);
+    setInstanceAttributes(first);
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount(kind), GL_UNSIGNED_INT, 0,
+                            static_cast<GLsizei>(count));
+}
+
+/**
+ * @brief Upload the vertices the following drawPrimitives() calls draw from.
+ */
+void ShapeRenderer::uploadPrimitives(const std::vector<PrimitiveVertex>& vertices) {
+    // Skip rendering in headless mode
+    if (!impl_->initialized || shaderManager_->isHeadlessMode() || vertices.empty()) {
+        return;
+    }
 
-    // Use the shape shader program
-    shaderManager_->useShader(impl_->shaderName);
+    shaderManager_->getRenderState()->bindArrayBuffer(impl_->primitiveVBO);
 
-    // Create projection matrix
-    Matrix4 projection =
-        glm::ortho(-10.0f, 10.0f, -10.0f * impl_->viewportHeight / impl_->viewportWidth,
-                   10.0f * impl_->viewportHeight / impl_->viewportWidth, -1.0f, 1.0f);
+    // Grow the buffer geometrically, then only overwrite its contents
+    const std::size_t bytes = vertices.size() * sizeof(PrimitiveVertex);
+    if (bytes > impl_->primitiveCapacity) {
+        impl_->primitiveCapacity = std::max(bytes, 2 * impl_->primitiveCapacity);
+        glBufferData(GL_ARRAY_BUFFER, impl_->primitiveCapacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+}
 
-    // Set projection uniform
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "projection", projection);
+/**
+ * @brief Draw quads [firstQuad, firstQuad + quadCount) of the uploaded
+ * primitives with one call. Counted in the statistics even when headless.
+ */
+void ShapeRenderer::drawPrimitives(std::uint32_t firstQuad, std::uint32_t quadCount) {
+    if (quadCount == 0) {
+        return;
+    }
+    impl_->primitiveStats.quads += quadCount;
+    ++impl_->primitiveStats.drawCalls;
 
-    // Create model matrix with translation, rotation and scale
-    Matrix4 model = Matrix4(1.0f);
-    model = glm::translate(model, glm::vec3((x1 + x2) / 2.0f, (y1 + y2) / 2.0f, 0.0f));
-    model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::scale(model, glm::vec3(length, thickness, 1.0f));
+    // Skip rendering in headless mode
+    if (!impl_->initialized || shaderManager_->isHeadlessMode()) {
+        return;
+    }
 
-    // Set model and color uniforms
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "model", model);
-    shaderManager_->setUniform4f(impl_->shaderName, "color", color);
+    RenderState& state = *shaderManager_->getRenderState();
+    state.setDepthTest(false);
+    shaderManager_->useShader(impl_->primitiveShader);
+    state.bindVertexArray(impl_->primitiveVAO);
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(firstQuad * PrimitiveBatch::kVerticesPerQuad),
+                 static_cast<GLsizei>(quadCount * PrimitiveBatch::kVerticesPerQuad));
+}
 
-    // Draw line using the rectangle VAO
-    glBindVertexArray(impl_->rectangleVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+const PrimitiveStats& ShapeRenderer::getPrimitiveStats() const {
+    return impl_->primitiveStats;
 }
 
 bool ShapeRenderer::isInitialized() const {
@@ -0,0 +1,80 @@
+#include "visualization/text_layout_cache.h"
+
+#include <functional>
+#include <utility>
+
+namespace visualization {
+
+std::size_t TextLayoutCache::KeyHash::operator()(const Key& key) const {
+    const std::size_t textHash = std::hash<std::string>()(key.text);
+    return textHash ^ (std::hash<float>()(key.scale) + 0x9e3779b9 + (textHash << 6) +
+                       (textHash >> 2));
+}
+
+TextLayoutCache::TextLayoutCache(std::size_t budgetBytes) : budget_(budgetBytes) {
+}
+
+const TextLayout* TextLayoutCache::find(std::string_view text, float scale) {
+    lookupKey_.text.assign(text);
+    lookupKey_.scale = scale;
+    auto it = index_.find(lookupKey_);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->layout;
+}
+
+/**
+ * @brief Store a layout as the most recently used one, replacing any
+ * layout of the same key, then evict down to the budget.
+ */
+const TextLayout& TextLayoutCache::insert(std::string_view text, float scale,
+                                          TextLayout layout) {
+    Key key{std::string(text), scale};
+    auto existing = index_.find(key);
+    if (existing != index_.end()) {
+        usage_ -= bytesOf(*existing->second);
+        entries_.erase(existing->second);
+        index_.erase(existing);
+    }
+
+    entries_.push_front({key, std::move(layout)});
+    index_.emplace(std::move(key), entries_.begin());
+    usage_ += bytesOf(entries_.front());
+    evict();
+    return entries_.front().layout;
+}
+
+void TextLayoutCache::clear() {
+    entries_.clear();
+    index_.clear();
+    usage_ = 0;
+}
+
+void TextLayoutCache::setBudget(std::size_t budgetBytes) {
+    budget_ = budgetBytes;
+    evict();
+}
+
+// The entry, its key in the index and their heap data; allocator overhead
+// is not counted
+std::size_t TextLayoutCache::bytesOf(const Entry& entry) {
+    return sizeof(Entry) + sizeof(Key) + sizeof(EntryList::iterator) +
+           2 * entry.key.text.size() + entry.layout.vertices.size() * sizeof(TextVertex);
+}
+
+void TextLayoutCache::evict() {
+    while (usage_ > budget_ && entries_.size() > 1) {
+        const Entry& oldest = entries_.back();
+        usage_ -= bytesOf(oldest);
+        index_.erase(oldest.key);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+}  // namespace visualization
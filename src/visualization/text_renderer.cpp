@@ -3,10 +3,15 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "constants.h"
+#include "visualization/utf8.h"
 
 namespace visualization {
 
@@ -14,7 +19,14 @@ struct TextRenderer::Impl {
     bool initialized = false;
     unsigned int textVAO = 0;
     unsigned int textVBO = 0;
+    std::size_t textCapacity = 0;  // Bytes allocated for textVBO
     std::string shaderName = "text";
+    ShaderHandle shader;
+
+    // Glyph quads queued until the next flush
+    std::vector<TextVertex> vertices;
+    TextStats stats;
+    TextLayoutCache layouts;
 };
 
 TextRenderer::TextRenderer(std::shared_ptr<FontManager> fontManager,
@@ -58,30 +70,45 @@ bool TextRenderer::initialize(RenderMode mode) {
     }
 
     // Create shader program for text rendering
-    const char* textVertexShaderSource = R"(
-        #version 330 core
-        layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+    // Text is laid out in fixed scene units, with the camera block's text
+    // projection
+    const std::string textVertexShaderSource =
+        std::string("#version 330 core\n") + kCameraBlockGlsl + R"(
+        layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 atlas pixel>
+        layout (location = 1) in vec4 aColor;
         out vec2 TexCoords;
-        
-        uniform mat4 projection;
+        out vec4 vColor;
         
         void main() {
-            gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+            gl_Position = textProjection * vec4(vertex.xy, 0.0, 1.0);
             TexCoords = vertex.zw;
+            vColor = aColor;
         }
     )";
 
-    const char* textFragmentShaderSource = R"(
-        #version 330 core
+    // One program draws either glyph mode; distance fields are cut at the
+    // outline with about a screen pixel of smoothing, whatever the scale
+    const bool distanceField = fontManager_->getGlyphMode() == GlyphMode::DistanceField;
+    const std::string textFragmentShaderSource =
+        std::string("#version 330 core\n") +
+        (distanceField ? "#define DISTANCE_FIELD\n" : "") + R"(
         in vec2 TexCoords;
+        in vec4 vColor;
         out vec4 color;
         
         uniform sampler2D text;
-        uniform vec4 textColor;
         
         void main() {
-            vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-            color = textColor * sampled;
+            // Glyph coordinates are in pixels, so they survive the atlas growing
+            vec2 uv = TexCoords / vec2(textureSize(text, 0));
+            float sampled = texture(text, uv).r;
+        #ifdef DISTANCE_FIELD
+            float width = max(fwidth(sampled), 1e-4);
+            float alpha = smoothstep(0.5 - width, 0.5 + width, sampled);
+        #else
+            float alpha = sampled;
+        #endif
+            color = vec4(vColor.rgb, vColor.a * alpha);
         }
     )";
 
@@ -91,15 +118,18 @@ bool TextRenderer::initialize(RenderMode mode) {
         return false;
     }
     std::cout << "TextRenderer shader program created successfully" << std::endl;
+    impl_->shader = shaderManager_->getShaderHandle(impl_->shaderName);
 
-    // Configure VAO/VBO for text rendering
+    // Configure VAO/VBO for text rendering; the buffer grows on demand
     glGenVertexArrays(1, &impl_->textVAO);
     glGenBuffers(1, &impl_->textVBO);
     glBindVertexArray(impl_->textVAO);
     glBindBuffer(GL_ARRAY_BUFFER, impl_->textVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    const auto stride = static_cast<GLsizei>(sizeof(TextVertex));
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(TextVertex, r));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
@@ -112,85 +142,151 @@ void TextRenderer::cleanup() {
     if (impl_->initialized && impl_->textVAO != 0) {
         glDeleteVertexArrays(1, &impl_->textVAO);
         glDeleteBuffers(1, &impl_->textVBO);
+        shaderManager_->getRenderState()->onVertexArrayDeleted(impl_->textVAO);
+        shaderManager_->getRenderState()->onBufferDeleted(impl_->textVBO);
         impl_->textVAO = 0;
         impl_->textVBO = 0;
+        impl_->textCapacity = 0;
     }
 
+    impl_->vertices.clear();
+    // Layouts refer to the glyphs of the font being cleaned up
+    impl_->layouts.clear();
+
     impl_->initialized = false;
 }
 
-void TextRenderer::drawText(const std::string& text, float x, float y, const Vector4& color) {
+/**
+ * @brief Queue the glyph quads of a string; the next flush() draws them.
+ *
+ * The string's layout comes from the layout cache, so redrawing a string
+ * only copies its quads into place. The string is UTF-8; glyphs the font
+ * cannot draw are skipped.
+ */
+void TextRenderer::drawText(std::string_view text, float x, float y, const Vector4& color) {
     if (!impl_->initialized || !fontManager_->isInitialized()) {
         return;
     }
 
-    // Skip rendering in headless mode
-    if (shaderManager_->isHeadlessMode()) {
-        return;
+    const TextLayout& layout = layoutText(text, constants::TEXT_SCALE);
+    std::vector<TextVertex>& vertices = impl_->vertices;
+    const std::size_t first = vertices.size();
+    vertices.insert(vertices.end(), layout.vertices.begin(), layout.vertices.end());
+    for (std::size_t i = first; i < vertices.size(); ++i) {
+        TextVertex& vertex = vertices[i];
+        vertex.x += x;
+        vertex.y += y;
+        vertex.r = color.r;
+        vertex.g = color.g;
+        vertex.b = color.b;
+        vertex.a = color.a;
     }
+}
 
-    // Activate shader
-    shaderManager_->useShader(impl_->shaderName);
+float TextRenderer::measureText(std::string_view text) {
+    if (!impl_->initialized || !fontManager_->isInitialized()) {
+        return 0.0f;
+    }
+    return layoutText(text, constants::TEXT_SCALE).width;
+}
 
-    // Set projection matrix (ortho using SCENE constants from constants.h)
-    // to match the same coordinate system used elsewhere
-    float halfWidth = constants::SCENE_HALF_WIDTH;
-    float halfHeight = constants::SCENE_HALF_HEIGHT;
-    Matrix4 projection = glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, -1.0f, 1.0f);
+TextLayoutCache& TextRenderer::getLayoutCache() {
+    return impl_->layouts;
+}
 
-    shaderManager_->setUniformMatrix4fv(impl_->shaderName, "projection", projection);
+const TextLayout& TextRenderer::layoutText(std::string_view text, float scale) {
+    if (const TextLayout* cached = impl_->layouts.find(text, scale)) {
+        return *cached;
+    }
 
-    // Set text color
-    shaderManager_->setUniform4f(impl_->shaderName, "textColor", color);
+    TextLayout layout;
+    layout.vertices.reserve(text.size() * 6);
+    auto vertex = [](float vx, float vy, float u, float v) {
+        return TextVertex{vx, vy, u, v, 0.0f, 0.0f, 0.0f, 0.0f};
+    };
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(impl_->textVAO);
+    // Glyph metrics are in atlas pixels, which differ from the font size
+    // for distance field glyphs
+    const float glyphScale = scale * fontManager_->getGlyphScale();
 
-    // Scale for text size
-    float uniformScale = constants::TEXT_SCALE;
-
-    // Iterate through characters
-    float xpos = x;
-    for (char c : text) {
-        const Character* ch = fontManager_->getCharacter(c);
+    // Iterate through code points; glyphs not drawn before are rasterized now
+    float xpos = 0.0f;
+    for (std::size_t i = 0; i < text.size();) {
+        const Character* ch = fontManager_->getCharacter(decodeUtf8(text, i));
         if (!ch) {
             continue;
         }
 
-        float w = ch->size.x * uniformScale;
-        float h = ch->size.y * uniformScale;
+        float w = ch->size.x * glyphScale;
+        float h = ch->size.y * glyphScale;
 
         // Calculate position for each character
-        float xpos_offset = xpos + ch->bearing.x * uniformScale;
-        float ypos_offset = y - (ch->size.y - ch->bearing.y) * uniformScale;
-
-        // Update VBO for each character
-        float vertices[6][4] = {{xpos_offset, ypos_offset + h, 0.0f, 0.0f},
-                                {xpos_offset, ypos_offset, 0.0f, 1.0f},
-                                {xpos_offset + w, ypos_offset, 1.0f, 1.0f},
+        float xpos_offset = xpos + ch->bearing.x * glyphScale;
+        float ypos_offset = -(ch->size.y - ch->bearing.y) * glyphScale;
+
+        // Two triangles; the top of the glyph is at the top of its region
+        const glm::vec2& atlasMin = ch->atlasMin;
+        const glm::vec2& atlasMax = ch->atlasMax;
+        const TextVertex topLeft = vertex(xpos_offset, ypos_offset + h, atlasMin.x, atlasMin.y);
+        const TextVertex bottomLeft = vertex(xpos_offset, ypos_offset, atlasMin.x, atlasMax.y);
+        const TextVertex bottomRight =
+            vertex(xpos_offset + w, ypos_offset, atlasMax.x, atlasMax.y);
+        const TextVertex topRight =
+            vertex(xpos_offset + w, ypos_offset + h, atlasMax.x, atlasMin.y);
+        layout.vertices.insert(layout.vertices.end(),
+                               {topLeft, bottomLeft, bottomRight, topLeft, bottomRight, topRight});
+
+        // Advance for next glyph; scaled before rounding, as distance field
+        // advances are in raster pixels
+        xpos += static_cast<float>(ch->advance) / 64.0f * glyphScale;
+    }
+    layout.width = xpos;
 
-                                {xpos_offset, ypos_offset + h, 0.0f, 0.0f},
-                                {xpos_offset + w, ypos_offset, 1.0f, 1.0f},
-                                {xpos_offset + w, ypos_offset + h, 1.0f, 0.0f}};
+    return impl_->layouts.insert(text, scale, std::move(layout));
+}
 
-        // Bind character texture
-        glBindTexture(GL_TEXTURE_2D, ch->textureID);
+/**
+ * @brief Draw all queued glyphs with one draw call from the atlas texture.
+ *
+ * Glyphs rasterized since the last flush are uploaded first.
+ */
+void TextRenderer::flush() {
+    if (impl_->vertices.empty()) {
+        return;
+    }
 
-        // Update VBO and render
-        glBindBuffer(GL_ARRAY_BUFFER, impl_->textVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    const std::vector<TextVertex>& vertices = impl_->vertices;
+    impl_->stats.glyphs += vertices.size() / 6;
+    ++impl_->stats.drawCalls;
 
-        // Render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    // Skip rendering in headless mode
+    if (!shaderManager_->isHeadlessMode()) {
+        RenderState& state = *shaderManager_->getRenderState();
+        shaderManager_->useShader(impl_->shader);
+        state.activeTexture(0);
+        // Binds the atlas itself when it uploads, which the bind below
+        // then matches
+        fontManager_->syncAtlasTexture();
+        state.bindTexture2D(fontManager_->getAtlasTexture());
+        state.bindVertexArray(impl_->textVAO);
+        state.bindArrayBuffer(impl_->textVBO);
+
+        // Grow the buffer geometrically, then only overwrite its contents
+        const std::size_t bytes = vertices.size() * sizeof(TextVertex);
+        if (bytes > impl_->textCapacity) {
+            impl_->textCapacity = std::max(bytes, 2 * impl_->textCapacity);
+            glBufferData(GL_ARRAY_BUFFER, impl_->textCapacity, nullptr, GL_STREAM_DRAW);
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
 
-        // Advance for next glyph
-        xpos += (ch->advance >> 6) * uniformScale;
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
     }
 
-    // Unbind
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    impl_->vertices.clear();
+}
+
+const TextStats& TextRenderer::getStats() const {
+    return impl_->stats;
 }
 
 bool TextRenderer::isInitialized() const {
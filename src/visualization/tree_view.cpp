@@ -28,6 +28,7 @@ void TreeView::render() {
 
     // Clear node positions for hit testing
     nodePositions_.clear();
+    labels_.clear();
 
     // Calculate coordinates for the tree view background
     float treeWidth = constants::TREE_VIEW_WIDTH;
@@ -38,6 +39,10 @@ void TreeView::render() {
     // Update the visible height
     visibleHeight_ = treeHeight;
 
+    // Drawn over the scene whatever is recorded around it
+    const RenderLayer sceneLayer = renderer_->getLayer();
+    renderer_->setLayer(RenderLayer::Overlay);
+
     // Draw background
     Vector4 treeViewBg(
         constants::colors::TREE_VIEW_BACKGROUND[0], constants::colors::TREE_VIEW_BACKGROUND[1],
@@ -51,8 +56,8 @@ void TreeView::render() {
     // Use small offset from the top to keep it visible
     float titleY = constants::SCENE_HALF_HEIGHT - 0.3f;
 
-    renderer_->drawText("Scene Hierarchy", treeX + constants::TREE_VIEW_TITLE_PADDING, titleY,
-                        titleColor);
+    labels_.push_back({"Scene Hierarchy", treeX + constants::TREE_VIEW_TITLE_PADDING, titleY,
+                       titleColor});
 
     // Start nodes below the title with a percentage-based spacing
     int yPosition = 1;  // Start with a simple index
@@ -70,8 +75,17 @@ void TreeView::render() {
     // Render all nodes in the tree recursively with updated spacing
     renderNode(root_, 0, yPosition);
 
+    // Text goes over the row backgrounds and connectors queued so far
+    for (const Label& label : labels_) {
+        renderer_->drawText(label.text, label.x, label.y, label.color);
+    }
+
     // Render scrollbar if needed
     renderScrollBar();
+
+    // The tree view is drawn after the canvas ends its frame
+    renderer_->flush();
+    renderer_->setLayer(sceneLayer);
 }
 
 void TreeView::renderNode(const std::shared_ptr<scene_graph::Node>& node, int depth,
@@ -125,10 +139,10 @@ void TreeView::renderNode(const std::shared_ptr<scene_graph::Node>& node, int de
     float maxTextWidth =
         treeViewWidth - (depth * indentSize) - 1.0f;  // Subtract padding and indentation
 
-    // Calculate node dimensions with constraint on width
-    float textWidth = std::min(node->getName().length() * constants::TEXT_CHAR_WIDTH_FACTOR +
-                                   constants::TEXT_WIDTH_PADDING,
-                               maxTextWidth);
+    // Calculate node dimensions with constraint on width, from the name's
+    // laid out width
+    float textWidth = std::min(
+        textRenderer_->measureText(node->getName()) + constants::TEXT_WIDTH_PADDING, maxTextWidth);
 
     // Store node position for hit testing (in scene coordinates)
     NodePosition pos;
@@ -171,7 +185,7 @@ void TreeView::renderNode(const std::shared_ptr<scene_graph::Node>& node, int de
 
         // Don't draw vertical lines for every child - that gets messy
         // Instead, draw a short vertical line from the connection point up
-        auto parent = node->getParent().lock();
+        const scene_graph::Node* parent = node->getParentNode();
         if (parent && !parent->getChildren().empty() && node == parent->getChildren().front()) {
             // Find the previous node position for better line drawing
             float parentY = sceneY + verticalSpacing;  // Approximate parent position
@@ -202,7 +216,7 @@ void TreeView::renderNode(const std::shared_ptr<scene_graph::Node>& node, int de
     float textX = sceneX + constants::TEXT_PADDING_X;
     float textY = sceneY - constants::TREE_TEXT_VERT_OFFSET;
 
-    renderer_->drawText(node->getName(), textX, textY, textColor);
+    labels_.push_back({node->getName(), textX, textY, textColor});
 
     // Update yPosition for the next node
     yPosition += 1;
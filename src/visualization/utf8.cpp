@@ -0,0 +1,59 @@
+#include "visualization/utf8.h"
+
+namespace visualization {
+
+/**
+ * @brief Decode one UTF-8 sequence.
+ *
+ * Rejects what the standard forbids: stray continuation bytes, truncated
+ * sequences, overlong forms, surrogates and values past U+10FFFF.
+ *
+ * @param text The string
+ * @param index Start of the sequence; moved to the start of the next one
+ * @return The code point, or U+FFFD if the sequence is malformed
+ */
+char32_t decodeUtf8(std::string_view text, std::size_t& index) {
+    const auto lead = static_cast<unsigned char>(text[index++]);
+    if (lead < 0x80) {
+        return lead;
+    }
+
+    std::size_t length = 0;
+    char32_t codePoint = 0;
+    char32_t minimum = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        length = 1;
+        codePoint = lead & 0x1F;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 2;
+        codePoint = lead & 0x0F;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 3;
+        codePoint = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        return kReplacementCharacter;
+    }
+
+    if (index + length > text.size()) {
+        return kReplacementCharacter;
+    }
+    for (std::size_t i = 0; i < length; ++i) {
+        const auto next = static_cast<unsigned char>(text[index + i]);
+        if ((next & 0xC0) != 0x80) {
+            return kReplacementCharacter;
+        }
+        codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+
+    if (codePoint < minimum || codePoint > 0x10FFFF ||
+        (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        return kReplacementCharacter;
+    }
+    index += length;
+    return codePoint;
+}
+
+}  // namespace visualization
@@ -35,6 +35,8 @@ bool Window::create(int width, int height, const std::string& title) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // Instanced shapes keep their draw order through the depth buffer
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);
 
     windowHandle_ = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
     if (windowHandle_ == nullptr) {
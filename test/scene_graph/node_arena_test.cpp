@@ -0,0 +1,121 @@
+#include "scene_graph/node_arena.h"
+#include "scene_graph/circle.h"
+#include "scene_graph/node.h"
+#include "scene_graph/rectangle.h"
+#include "types.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace scene_graph {
+
+namespace {
+
+// Counts the allocations that fall through to the default memory resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace
+
+class NodeArenaTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    previous = std::pmr::set_default_resource(&counting);
+  }
+  void TearDown() override { std::pmr::set_default_resource(previous); }
+
+  CountingResource counting;
+  std::pmr::memory_resource *previous = nullptr;
+};
+
+TEST_F(NodeArenaTest, Create_BuildsWorkingNodes) {
+  NodeArena arena;
+  auto root = arena.create<Node>("root");
+  auto rect = arena.create<Rectangle>("rect", Vector2(2.0f, 3.0f));
+  auto circle = arena.create<Circle>("circle", 4.0f);
+
+  root->addChild(rect);
+  rect->addChild(circle);
+  rect->setPosition(Vector2(1.0f, 0.0f));
+  circle->setPosition(Vector2(0.0f, 1.0f));
+
+  EXPECT_EQ(root->getName(), "root");
+  EXPECT_EQ(rect->getSize(), Vector2(2.0f, 3.0f));
+  EXPECT_FLOAT_EQ(circle->getRadius(), 4.0f);
+  EXPECT_EQ(circle->getParentNode(), rect.get());
+  EXPECT_EQ(root->getSubtreeSize(), 3u);
+  EXPECT_EQ(circle->getGlobalTransform().getPosition(), Vector2(1.0f, 1.0f));
+}
+
+TEST_F(NodeArenaTest, NamesAndChildListsStayInArena) {
+  // Names too long for the small-string buffer
+  auto heapNode = std::make_shared<Node>("a node name that needs the heap");
+  EXPECT_GT(counting.allocations, 0u);
+
+  // The arena only takes a few large chunks from the default resource
+  counting.allocations = 0;
+  {
+    NodeArena arena;
+    auto root = arena.create<Node>("a node name that needs the heap");
+    for (int i = 0; i < 100; ++i) {
+      root->addChild(arena.create<Rectangle>("a rectangle name on the heap"));
+    }
+    root->setName("another name that is too long to store inline");
+  }
+  EXPECT_LE(counting.allocations, 4u);
+}
+
+TEST_F(NodeArenaTest, Siblings_AreAdjacentInMemory) {
+  NodeArena arena;
+  auto root = arena.create<Node>("root");
+  std::vector<std::shared_ptr<Rectangle>> rects;
+  for (int i = 0; i < 16; ++i) {
+    rects.push_back(arena.create<Rectangle>("rect"));
+    root->addChild(rects.back());
+  }
+
+  // Each node and its control block share one pool block; consecutive nodes
+  // of the same type are a small stride apart, except where the pool starts
+  // a new chunk
+  std::size_t adjacent = 0;
+  for (std::size_t i = 1; i < rects.size(); ++i) {
+    auto previous = reinterpret_cast<std::uintptr_t>(rects[i - 1].get());
+    auto current = reinterpret_cast<std::uintptr_t>(rects[i].get());
+    auto distance =
+        current > previous ? current - previous : previous - current;
+    if (distance < 2 * sizeof(Rectangle)) {
+      ++adjacent;
+    }
+  }
+  EXPECT_GE(adjacent, rects.size() - 3);
+}
+
+TEST_F(NodeArenaTest, FreedNodes_AreRecycled) {
+  NodeArena arena;
+  auto first = arena.create<Circle>("circle");
+  const Circle *address = first.get();
+  first.reset();
+
+  auto second = arena.create<Circle>("circle");
+  EXPECT_EQ(second.get(), address);
+}
+
+} // namespace scene_graph
@@ -0,0 +1,69 @@
+#include "scene_graph/node.h"
+#include "scene_graph/node_handle.h"
+#include "types.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace scene_graph {
+using std::make_shared;
+
+class NodeHandleTest : public ::testing::Test {
+protected:
+  NodeRegistry &registry = NodeRegistry::instance();
+};
+
+TEST_F(NodeHandleTest, Handle_ResolvesToLiveNode) {
+  auto node = make_shared<Node>("node");
+  NodeHandle handle = node->getHandle();
+
+  EXPECT_FALSE(handle.isNull());
+  EXPECT_TRUE(registry.isValid(handle));
+  EXPECT_EQ(registry.get(handle), node.get());
+  EXPECT_EQ(registry.get(NodeHandle()), nullptr);
+}
+
+TEST_F(NodeHandleTest, Handle_InvalidAfterDestructionAndSlotReuse) {
+  auto node = make_shared<Node>("node");
+  NodeHandle stale = node->getHandle();
+  std::size_t liveCount = registry.size();
+
+  node.reset();
+  EXPECT_FALSE(registry.isValid(stale));
+  EXPECT_EQ(registry.size(), liveCount - 1);
+
+  // The freed slot is reused with a new generation
+  auto replacement = make_shared<Node>("replacement");
+  EXPECT_EQ(replacement->getHandle().index, stale.index);
+  EXPECT_NE(replacement->getHandle(), stale);
+  EXPECT_EQ(registry.get(stale), nullptr);
+  EXPECT_EQ(registry.get(replacement->getHandle()), replacement.get());
+}
+
+TEST_F(NodeHandleTest, ParentHandle_FollowsHierarchy) {
+  auto parent = make_shared<Node>("parent");
+  auto child = make_shared<Node>("child");
+  EXPECT_TRUE(child->getParentHandle().isNull());
+
+  parent->addChild(child);
+  EXPECT_EQ(child->getParentHandle(), parent->getHandle());
+  EXPECT_EQ(child->getParentNode(), parent.get());
+
+  // The shared_ptr API still works on top of the handles
+  EXPECT_EQ(child->getParent().lock(), parent);
+  EXPECT_TRUE(child->hasParent(parent));
+
+  parent->removeChild(child);
+  EXPECT_EQ(child->getParentNode(), nullptr);
+  EXPECT_TRUE(child->isOrphaned());
+}
+
+TEST_F(NodeHandleTest, DestroyedParent_OrphansChild) {
+  auto parent = make_shared<Node>("parent");
+  auto child = make_shared<Node>("child");
+  parent->addChild(child);
+
+  parent.reset();
+  EXPECT_TRUE(child->isOrphaned());
+  EXPECT_TRUE(child->getParent().expired());
+}
+} // namespace scene_graph
@@ -1,7 +1,11 @@
+#include "scene_graph/circle.h"
 #include "scene_graph/node.h"
+#include "scene_graph/rectangle.h"
 #include "types.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace scene_graph {
 using namespace std;
@@ -18,6 +22,20 @@ TEST_F(NodeTest, Constructor_SetsName) {
   EXPECT_EQ(node->getName(), "testNode");
 }
 
+TEST_F(NodeTest, SetName_CopiesOutOfLine) {
+  std::string name = "a name longer than the small-string buffer";
+  node->setName(name);
+  name.assign(name.size(), 'x');
+  EXPECT_EQ(node->getName(), "a name longer than the small-string buffer");
+
+  // Renaming from the node's own name must not read freed memory
+  node->setName(node->getName().substr(2, 4));
+  EXPECT_EQ(node->getName(), "name");
+
+  node->setName("");
+  EXPECT_TRUE(node->getName().empty());
+}
+
 TEST_F(NodeTest, SetName_UpdatesName) {
   node->setName("newName");
   EXPECT_EQ(node->getName(), "newName");
@@ -156,4 +174,215 @@ TEST_F(NodeTest, Memory_ParentChildCleanup) {
   // Verify parent's children list is updated
   EXPECT_EQ(parent->getChildren().size(), 0);
 }
+
+TEST_F(NodeTest, GlobalTransform_CachedUntilChanged) {
+  shared_ptr<Node> parent = make_shared<Node>("parent");
+  parent->addChild(node);
+  EXPECT_TRUE(node->isGlobalTransformDirty());
+
+  node->getGlobalTransform();
+  EXPECT_FALSE(node->isGlobalTransformDirty());
+  EXPECT_FALSE(parent->isGlobalTransformDirty());
+
+  // Querying again must not invalidate anything
+  node->getGlobalTransform();
+  EXPECT_FALSE(node->isGlobalTransformDirty());
+}
+
+TEST_F(NodeTest, GlobalTransform_ParentChangePropagatesToDescendants) {
+  shared_ptr<Node> parent = make_shared<Node>("parent");
+  shared_ptr<Node> grandchild = make_shared<Node>("grandchild");
+  parent->addChild(node);
+  node->addChild(grandchild);
+  grandchild->setPosition(Vector2(1.0f, 0.0f));
+
+  EXPECT_NEAR(grandchild->getGlobalTransform().getPosition().x, 1.0f, 0.0001f);
+
+  parent->setPosition(Vector2(10.0f, 5.0f));
+  EXPECT_TRUE(node->isGlobalTransformDirty());
+  EXPECT_TRUE(grandchild->isGlobalTransformDirty());
+
+  Vector2 worldPos = grandchild->getGlobalTransform().getPosition();
+  EXPECT_NEAR(worldPos.x, 11.0f, 0.0001f);
+  EXPECT_NEAR(worldPos.y, 5.0f, 0.0001f);
+}
+
+TEST_F(NodeTest, GlobalTransform_SiblingChangeKeepsCache) {
+  shared_ptr<Node> parent = make_shared<Node>("parent");
+  shared_ptr<Node> sibling = make_shared<Node>("sibling");
+  parent->addChild(node);
+  parent->addChild(sibling);
+  node->getGlobalTransform();
+  sibling->getGlobalTransform();
+
+  sibling->setRotation(90.0f);
+  EXPECT_TRUE(sibling->isGlobalTransformDirty());
+  EXPECT_FALSE(node->isGlobalTransformDirty());
+}
+
+TEST_F(NodeTest, GlobalTransform_ReparentingInvalidatesCache) {
+  shared_ptr<Node> parent1 = make_shared<Node>("parent1");
+  shared_ptr<Node> parent2 = make_shared<Node>("parent2");
+  parent1->setPosition(Vector2(1.0f, 0.0f));
+  parent2->setPosition(Vector2(0.0f, 2.0f));
+
+  parent1->addChild(node);
+  EXPECT_NEAR(node->getGlobalTransform().getPosition().x, 1.0f, 0.0001f);
+
+  parent2->addChild(node);
+  Vector2 worldPos = node->getGlobalTransform().getPosition();
+  EXPECT_NEAR(worldPos.x, 0.0f, 0.0001f);
+  EXPECT_NEAR(worldPos.y, 2.0f, 0.0001f);
+
+  parent2->removeChild(node);
+  worldPos = node->getGlobalTransform().getPosition();
+  EXPECT_NEAR(worldPos.y, 0.0f, 0.0001f);
+}
+
+TEST_F(NodeTest, GlobalTransform_SetLocalTransformInvalidatesCache) {
+  node->getGlobalTransform();
+
+  Transform transform;
+  transform.setPosition(Vector2(3.0f, 4.0f));
+  node->setLocalTransform(transform);
+  EXPECT_TRUE(node->isGlobalTransformDirty());
+  EXPECT_NEAR(node->getGlobalTransform().getPosition().y, 4.0f, 0.0001f);
+}
+
+TEST_F(NodeTest, RotateBy_InvalidatesCache) {
+  node->setRotation(30.0f);
+  node->getGlobalTransform();
+
+  node->rotateBy(Rotation2::fromDegrees(60.0f));
+  EXPECT_TRUE(node->isGlobalTransformDirty());
+  EXPECT_NEAR(node->getRotation(), 90.0f, 0.0001f);
+  EXPECT_NEAR(node->getGlobalTransform().getRotation(), 90.0f, 0.0001f);
+}
+
+TEST_F(NodeTest, SubtreeSize_TracksHierarchyChanges) {
+  auto parent = make_shared<Node>("parent");
+  auto child = make_shared<Node>("child");
+  auto grandchild = make_shared<Node>("grandchild");
+  child->addChild(grandchild);
+  EXPECT_EQ(child->getSubtreeSize(), 2);
+
+  node->addChild(parent);
+  parent->addChild(child);
+  EXPECT_EQ(node->getSubtreeSize(), 4);
+  EXPECT_EQ(parent->getSubtreeSize(), 3);
+
+  // Reparenting moves the whole subtree's count
+  node->addChild(child);
+  EXPECT_EQ(parent->getSubtreeSize(), 1);
+  EXPECT_EQ(node->getSubtreeSize(), 4);
+
+  node->removeChild(child);
+  EXPECT_EQ(node->getSubtreeSize(), 2);
+  EXPECT_EQ(child->getSubtreeSize(), 2);
+}
+
+TEST_F(NodeTest, Footprint_StaysCompact) {
+  RecordProperty("NodeBytes", static_cast<int>(sizeof(Node)));
+
+  // Budgets for 64-bit builds; raise them deliberately, not by accident.
+  // The per-node bounds revision that lets the hit test BVH refit only
+  // moved shapes costs 8 bytes
+  EXPECT_LE(sizeof(ChildList), 48u);
+  EXPECT_LE(sizeof(Node), 200u);
+  EXPECT_LE(sizeof(Rectangle), 224u);
+  EXPECT_LE(sizeof(Circle), 224u);
+}
+
+TEST_F(NodeTest, Children_SpillBeyondInlineCapacity) {
+  std::vector<shared_ptr<Node>> children;
+  for (std::uint32_t i = 0; i <= ChildList::kInlineCapacity; ++i) {
+    children.push_back(make_shared<Node>("child"));
+    node->addChild(children.back());
+    EXPECT_EQ(node->getChildren().isInline(),
+              i < ChildList::kInlineCapacity);
+  }
+
+  // Order is preserved across the spill and across removal
+  node->removeChild(children[0]);
+  ASSERT_EQ(node->getChildren().size(), children.size() - 1);
+  for (std::size_t i = 1; i < children.size(); ++i) {
+    EXPECT_EQ(node->getChildren()[i - 1], children[i]);
+    EXPECT_EQ(children[i]->getParentNode(), node.get());
+  }
+  EXPECT_EQ(children[0]->getParentNode(), nullptr);
+}
+
+TEST_F(NodeTest, Destructor_ReleasesInlineAndSpilledChildren) {
+  std::weak_ptr<Node> inlineChild;
+  std::weak_ptr<Node> spilledChild;
+  {
+    auto small = make_shared<Node>("small");
+    auto child = make_shared<Node>("child");
+    small->addChild(child);
+    inlineChild = child;
+
+    auto large = make_shared<Node>("large");
+    for (std::uint32_t i = 0; i <= ChildList::kInlineCapacity; ++i) {
+      auto other = make_shared<Node>("child");
+      large->addChild(other);
+      spilledChild = other;
+    }
+  }
+  EXPECT_TRUE(inlineChild.expired());
+  EXPECT_TRUE(spilledChild.expired());
+}
+
+TEST_F(NodeTest, SubtreeBounds_CoverDescendants) {
+  auto body = make_shared<Rectangle>("body", Vector2(4.0f, 2.0f));
+  auto wheel = make_shared<Circle>("wheel", 1.0f);
+  node->addChild(body);
+  body->addChild(wheel);
+  node->setPosition(Vector2(10.0f, 0.0f));
+  wheel->setPosition(Vector2(3.0f, -2.0f));
+
+  // A plain node has no extent of its own
+  EXPECT_TRUE(node->getWorldBounds().isEmpty());
+
+  const Aabb &bounds = node->getSubtreeBounds();
+  EXPECT_FALSE(node->isSubtreeBoundsDirty());
+  EXPECT_FLOAT_EQ(bounds.min.x, 8.0f);
+  EXPECT_FLOAT_EQ(bounds.max.x, 14.0f);
+  EXPECT_FLOAT_EQ(bounds.min.y, -3.0f);
+  EXPECT_FLOAT_EQ(bounds.max.y, 1.0f);
+  EXPECT_FALSE(wheel->isSubtreeBoundsDirty());
+}
+
+TEST_F(NodeTest, SubtreeBounds_UpdateOnMoveResizeAndReparent) {
+  auto body = make_shared<Rectangle>("body", Vector2(2.0f, 2.0f));
+  auto wheel = make_shared<Circle>("wheel", 1.0f);
+  node->addChild(body);
+  body->addChild(wheel);
+  node->getSubtreeBounds();
+
+  // Moving a descendant dirties its ancestors, but not its siblings
+  auto sibling = make_shared<Rectangle>("sibling");
+  node->addChild(sibling);
+  node->getSubtreeBounds();
+  wheel->setPosition(Vector2(5.0f, 0.0f));
+  EXPECT_TRUE(node->isSubtreeBoundsDirty());
+  EXPECT_TRUE(body->isSubtreeBoundsDirty());
+  EXPECT_FALSE(sibling->isSubtreeBoundsDirty());
+  EXPECT_FLOAT_EQ(node->getSubtreeBounds().max.x, 6.0f);
+
+  // Moving an ancestor dirties the whole subtree below it
+  body->setPosition(Vector2(0.0f, 1.0f));
+  EXPECT_TRUE(wheel->isSubtreeBoundsDirty());
+  EXPECT_FLOAT_EQ(node->getSubtreeBounds().max.y, 2.0f);
+
+  wheel->setRadius(3.0f);
+  EXPECT_TRUE(node->isSubtreeBoundsDirty());
+  EXPECT_FLOAT_EQ(node->getSubtreeBounds().max.x, 8.0f);
+
+  body->setSize(Vector2(2.0f, 10.0f));
+  EXPECT_FLOAT_EQ(node->getSubtreeBounds().max.y, 6.0f);
+
+  body->removeChild(wheel);
+  EXPECT_FLOAT_EQ(node->getSubtreeBounds().max.x, 1.0f);
+}
+
 } // namespace scene_graph
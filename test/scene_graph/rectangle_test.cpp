@@ -1,5 +1,6 @@
 #include "scene_graph/rectangle.h"
 #include "types.h"
+#include <cmath>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -63,4 +64,27 @@ TEST_F(RectangleTest, ContainsPoint_WithRotation) {
   // A point that would be inside without rotation, but outside with rotation
   EXPECT_FALSE(rectangle->containsPoint(Vector2(1.0F, 1.0F)));
 }
-} // namespace scene_graph
\ No newline at end of file
+
+TEST_F(RectangleTest, ContainsPoint_UsesWorldTransform) {
+  auto parent = std::make_shared<Node>("parent");
+  parent->setPosition(Vector2(10.0F, 0.0F));
+  parent->addChild(rectangle);
+  rectangle->setPosition(Vector2(1.0F, 0.0F));
+
+  EXPECT_TRUE(rectangle->containsPoint(Vector2(11.0F, 0.0F)));
+  EXPECT_FALSE(rectangle->containsPoint(Vector2(1.0F, 0.0F)));
+}
+
+TEST_F(RectangleTest, WorldBounds_CoverRotatedRectangle) {
+  rectangle->setSize(Vector2(2.0F, 2.0F));
+  rectangle->setPosition(Vector2(3.0F, 0.0F));
+  rectangle->setRotation(45.0F);
+
+  Aabb bounds = rectangle->getWorldBounds();
+  const float halfDiagonal = std::sqrt(2.0F);
+  EXPECT_NEAR(bounds.min.x, 3.0F - halfDiagonal, 1e-5F);
+  EXPECT_NEAR(bounds.max.x, 3.0F + halfDiagonal, 1e-5F);
+  EXPECT_NEAR(bounds.min.y, -halfDiagonal, 1e-5F);
+  EXPECT_NEAR(bounds.max.y, halfDiagonal, 1e-5F);
+}
+} // namespace scene_graph
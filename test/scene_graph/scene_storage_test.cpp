@@ -0,0 +1,95 @@
+#include "scene_graph/node.h"
+#include "scene_graph/scene_storage.h"
+#include "types.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace scene_graph {
+using std::make_shared;
+
+class SceneStorageTest : public ::testing::Test {
+protected:
+  static void expectMatricesNear(const Affine2 &actual, const Affine2 &expected) {
+    EXPECT_NEAR(actual.a, expected.a, 0.0001f);
+    EXPECT_NEAR(actual.b, expected.b, 0.0001f);
+    EXPECT_NEAR(actual.c, expected.c, 0.0001f);
+    EXPECT_NEAR(actual.d, expected.d, 0.0001f);
+    EXPECT_NEAR(actual.tx, expected.tx, 0.0001f);
+    EXPECT_NEAR(actual.ty, expected.ty, 0.0001f);
+  }
+};
+
+TEST_F(SceneStorageTest, Add_KeepsParentBeforeChild) {
+  SceneStorage storage;
+  SceneStorage::Slot root = storage.add(SceneStorage::kInvalidSlot);
+  SceneStorage::Slot child = storage.add(root);
+
+  EXPECT_EQ(storage.size(), 2);
+  EXPECT_EQ(storage.getParent(root), SceneStorage::kInvalidSlot);
+  EXPECT_EQ(storage.getParent(child), root);
+
+  // A parent that is not stored yet is rejected
+  EXPECT_EQ(storage.add(5), SceneStorage::kInvalidSlot);
+  EXPECT_EQ(storage.size(), 2);
+}
+
+TEST_F(SceneStorageTest, UpdateWorldTransforms_ComposesWithParent) {
+  SceneStorage storage;
+  NodeView root = storage.view(storage.add(SceneStorage::kInvalidSlot));
+  NodeView child = storage.view(storage.add(root.getSlot()));
+
+  root.setPosition(Vector2(5.0f, 0.0f));
+  root.setRotation(90.0f);
+  child.setPosition(Vector2(0.0f, 1.0f));
+  storage.updateWorldTransforms();
+
+  // Same hierarchy as NodeTest.TransformPropagation_ChildInheritsParentTransform
+  const Affine2 &world = child.getWorldMatrix();
+  EXPECT_NEAR(world.tx, 4.0f, 0.0001f);
+  EXPECT_NEAR(world.ty, 0.0f, 0.0001f);
+  EXPECT_TRUE(child.hasParent());
+  EXPECT_FALSE(root.hasParent());
+}
+
+TEST_F(SceneStorageTest, FromNode_MatchesNodeGlobalTransforms) {
+  auto root = make_shared<Node>("root");
+  auto body = make_shared<Node>("body");
+  auto wheel = make_shared<Node>("wheel");
+  auto hubcap = make_shared<Node>("hubcap");
+  root->addChild(body);
+  body->addChild(wheel);
+  wheel->addChild(hubcap);
+
+  root->setPosition(Vector2(1.0f, 2.0f));
+  root->setRotation(30.0f);
+  body->setScale(Vector2(2.0f, 1.5f));
+  wheel->setPosition(Vector2(1.5f, -0.5f));
+  wheel->setRotation(45.0f);
+  hubcap->setPosition(Vector2(0.2f, 0.1f));
+
+  SceneStorage storage = SceneStorage::fromNode(*root);
+  ASSERT_EQ(storage.size(), 4);
+
+  expectMatricesNear(storage.getWorldMatrix(0),
+                     root->getGlobalTransform().getAffine());
+  expectMatricesNear(storage.getWorldMatrix(1),
+                     body->getGlobalTransform().getAffine());
+  expectMatricesNear(storage.getWorldMatrix(2),
+                     wheel->getGlobalTransform().getAffine());
+  expectMatricesNear(storage.getWorldMatrix(3),
+                     hubcap->getGlobalTransform().getAffine());
+}
+
+TEST_F(SceneStorageTest, NodeView_MirrorsTransformApi) {
+  SceneStorage storage;
+  NodeView view = storage.view(storage.add(SceneStorage::kInvalidSlot));
+
+  view.setPosition(Vector2(3.0f, 4.0f));
+  view.setRotation(-90.0f);
+  view.setScale(Vector2(2.0f, 3.0f));
+
+  EXPECT_EQ(view.getPosition(), Vector2(3.0f, 4.0f));
+  EXPECT_NEAR(view.getRotation(), 270.0f, 0.0001f);
+  EXPECT_EQ(view.getScale(), Vector2(2.0f, 3.0f));
+}
+} // namespace scene_graph
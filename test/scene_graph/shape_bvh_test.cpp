@@ -0,0 +1,107 @@
+#include "scene_graph/shape_bvh.h"
+#include "scene_graph/circle.h"
+#include "scene_graph/rectangle.h"
+#include "types.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace scene_graph {
+using std::make_shared;
+
+class ShapeBvhTest : public ::testing::Test {
+protected:
+  // A grid of overlapping, rotated rectangles and circles
+  void SetUp() override {
+    for (int i = 0; i < 400; ++i) {
+      std::shared_ptr<Shape> shape;
+      if (i % 3 == 0) {
+        shape = make_shared<Circle>("circle", 0.4f + 0.1f * (i % 5));
+      } else {
+        shape = make_shared<Rectangle>(
+            "rect", Vector2(0.5f + 0.2f * (i % 4), 1.5f - 0.2f * (i % 6)));
+      }
+      shape->setPosition(Vector2(0.7f * (i % 20), 0.6f * (i / 20)));
+      shape->setRotation(23.0f * i);
+      owned.push_back(shape);
+      shapes.push_back(shape.get());
+    }
+  }
+
+  // The first shape in priority order that contains the point
+  Shape *linearHitTest(const Vector2 &point) const {
+    for (Shape *shape : shapes) {
+      if (shape->containsPoint(point)) {
+        return shape;
+      }
+    }
+    return nullptr;
+  }
+
+  void expectMatchesLinear(const ShapeBvh &bvh) const {
+    for (float y = -1.0f; y < 13.0f; y += 0.23f) {
+      for (float x = -1.0f; x < 15.0f; x += 0.19f) {
+        ASSERT_EQ(bvh.hitTest(Vector2(x, y)), linearHitTest(Vector2(x, y)))
+            << "at (" << x << ", " << y << ")";
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<Shape>> owned;
+  std::vector<Shape *> shapes;
+};
+
+TEST_F(ShapeBvhTest, HitTest_MatchesLinearScanInPriorityOrder) {
+  ShapeBvh bvh;
+  bvh.build(shapes);
+  EXPECT_EQ(bvh.size(), shapes.size());
+  expectMatchesLinear(bvh);
+}
+
+TEST_F(ShapeBvhTest, Refit_FollowsMovedAndResizedShapes) {
+  ShapeBvh bvh;
+  bvh.build(shapes);
+
+  for (std::size_t i = 0; i < owned.size(); i += 7) {
+    owned[i]->setPosition(owned[i]->getPosition() + Vector2(3.0f, -2.0f));
+  }
+  static_cast<Circle *>(shapes[0])->setRadius(5.0f);
+  bvh.refit();
+
+  expectMatchesLinear(bvh);
+  EXPECT_EQ(bvh.hitTest(Vector2(4.0f, 0.0f)), shapes[0]);
+}
+
+TEST_F(ShapeBvhTest, Refit_UpdatesOnlyShapesThatChanged) {
+  ShapeBvh bvh;
+  bvh.build(shapes);
+  EXPECT_EQ(bvh.refit(), 0u);
+
+  owned[10]->setPosition(Vector2(-20.0f, -20.0f));
+  static_cast<Circle *>(shapes[3])->setRadius(2.0f);
+  EXPECT_EQ(bvh.refit(), 2u);
+  EXPECT_EQ(bvh.refit(), 0u);
+  expectMatchesLinear(bvh);
+  EXPECT_EQ(bvh.hitTest(Vector2(-20.0f, -20.0f)), shapes[10]);
+
+  // Moving a parent changes the world bounds of the shapes below it
+  auto parent = make_shared<Node>("parent");
+  parent->addChild(owned[20]);
+  parent->addChild(owned[21]);
+  bvh.build(shapes);
+  parent->setPosition(Vector2(0.0f, 30.0f));
+  EXPECT_EQ(bvh.refit(), 2u);
+  expectMatchesLinear(bvh);
+}
+
+TEST_F(ShapeBvhTest, EmptyAndCleared_HitNothing) {
+  ShapeBvh bvh;
+  EXPECT_EQ(bvh.hitTest(Vector2(0.0f, 0.0f)), nullptr);
+
+  bvh.build(shapes);
+  bvh.clear();
+  EXPECT_TRUE(bvh.empty());
+  EXPECT_EQ(bvh.hitTest(Vector2(0.0f, 0.0f)), nullptr);
+}
+
+} // namespace scene_graph
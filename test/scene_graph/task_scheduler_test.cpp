@@ -0,0 +1,147 @@
+#include "scene_graph/node.h"
+#include "scene_graph/task_scheduler.h"
+#include "scene_graph/transform_batch.h"
+#include "types.h"
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace scene_graph {
+using std::make_shared;
+
+class TaskSchedulerTest : public ::testing::Test {
+protected:
+  // Many small car-like subtrees under one root, plus one large subtree
+  static std::vector<NodePtr> buildWideScene(int cars) {
+    std::vector<NodePtr> nodes;
+    auto root = make_shared<Node>("Root");
+    nodes.push_back(root);
+    for (int i = 0; i < cars; ++i) {
+      auto car = make_shared<Node>("Car");
+      car->setPosition(Vector2(0.1f * i, -0.05f * i));
+      car->setRotation(3.0f * i);
+      root->addChild(car);
+      nodes.push_back(car);
+      for (int w = 0; w < 4; ++w) {
+        auto wheel = make_shared<Node>("Wheel");
+        wheel->setPosition(Vector2(w - 1.5f, -0.5f));
+        wheel->setRotation(11.0f * (i + w));
+        car->addChild(wheel);
+        nodes.push_back(wheel);
+        auto hubcap = make_shared<Node>("Hubcap");
+        hubcap->setScale(Vector2(0.5f, 0.5f));
+        wheel->addChild(hubcap);
+        nodes.push_back(hubcap);
+      }
+    }
+    // A deep chain that is larger than one task on its own
+    NodePtr parent = root;
+    for (int i = 0; i < 3000; ++i) {
+      auto link = make_shared<Node>("Link");
+      link->setPosition(Vector2(0.01f, 0.0f));
+      link->setRotation(0.1f);
+      parent->addChild(link);
+      nodes.push_back(link);
+      parent = link;
+    }
+    return nodes;
+  }
+};
+
+TEST_F(TaskSchedulerTest, Wait_RunsAllTasks) {
+  for (std::size_t threads : {1, 4}) {
+    TaskScheduler scheduler(threads);
+    EXPECT_EQ(scheduler.getThreadCount(), threads);
+
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 1000; ++i) {
+      scheduler.submit([&counter]() { counter.fetch_add(1); });
+    }
+    scheduler.wait();
+    EXPECT_EQ(counter.load(), 1000);
+  }
+}
+
+TEST_F(TaskSchedulerTest, Wait_IncludesNestedTasks) {
+  TaskScheduler scheduler(4);
+  std::atomic<int> leaves{0};
+
+  // Binary recursion producing 2^10 leaf tasks
+  std::function<void(int)> split = [&](int depth) {
+    if (depth == 0) {
+      leaves.fetch_add(1);
+      return;
+    }
+    scheduler.submit([&split, depth]() { split(depth - 1); });
+    scheduler.submit([&split, depth]() { split(depth - 1); });
+  };
+  scheduler.submit([&split]() { split(10); });
+  scheduler.wait();
+
+  EXPECT_EQ(leaves.load(), 1024);
+}
+
+TEST_F(TaskSchedulerTest, Wait_RethrowsTaskExceptionsOnceAllTasksFinish) {
+  TaskScheduler scheduler(4);
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 100; ++i) {
+    scheduler.submit([&ran, i]() {
+      ++ran;
+      if (i % 10 == 3) {
+        throw std::runtime_error("task failed");
+      }
+    });
+  }
+  EXPECT_THROW(scheduler.wait(), std::runtime_error);
+  EXPECT_EQ(ran.load(), 100);
+
+  // The failure is reported once and the scheduler keeps working
+  scheduler.submit([&ran]() { ++ran; });
+  EXPECT_NO_THROW(scheduler.wait());
+  EXPECT_EQ(ran.load(), 101);
+}
+
+TEST_F(TaskSchedulerTest, Wait_ThrowsWhenCalledFromATask) {
+  TaskScheduler scheduler(2);
+  std::atomic<bool> finished{false};
+  scheduler.submit([&scheduler, &finished]() {
+    scheduler.wait();
+    finished = true;
+  });
+  EXPECT_THROW(scheduler.wait(), std::logic_error);
+  EXPECT_FALSE(finished.load());
+}
+
+TEST_F(TaskSchedulerTest, ParallelUpdate_MatchesSerialUpdate) {
+  auto serial = buildWideScene(500);
+  auto parallel = buildWideScene(500);
+  ASSERT_EQ(parallel.front()->getSubtreeSize(), parallel.size());
+
+  TaskScheduler scheduler(4);
+  updateWorldTransforms(*serial.front());
+  updateWorldTransforms(*parallel.front(), scheduler);
+
+  for (std::size_t i = 0; i < parallel.size(); ++i) {
+    ASSERT_FALSE(parallel[i]->isGlobalTransformDirty()) << "node " << i;
+    EXPECT_EQ(std::memcmp(&parallel[i]->getGlobalTransform().getAffine(),
+                          &serial[i]->getGlobalTransform().getAffine(),
+                          sizeof(Affine2)),
+              0)
+        << "node " << i;
+  }
+
+  // A second frame only touches what moved
+  parallel[1]->setPosition(Vector2(5.0f, 5.0f));
+  updateWorldTransforms(*parallel.front(), scheduler);
+  EXPECT_FALSE(parallel[2]->isGlobalTransformDirty());
+  const Node &wheel = *parallel[2];
+  Transform expected = Transform::combine(parallel[1]->getGlobalTransform(),
+                                          wheel.getLocalTransform());
+  EXPECT_NEAR(parallel[2]->getGlobalTransform().getPosition().x,
+              expected.getPosition().x, 0.0001f);
+}
+} // namespace scene_graph
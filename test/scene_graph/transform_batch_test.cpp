@@ -0,0 +1,106 @@
+#include "scene_graph/node.h"
+#include "scene_graph/transform_batch.h"
+#include "types.h"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace scene_graph {
+using std::make_shared;
+
+class TransformBatchTest : public ::testing::Test {
+protected:
+  // Deterministic, irregular transforms so every lane sees different values
+  static Affine2 makeAffine(int seed) {
+    Transform transform;
+    transform.setPosition(Vector2(0.37f * seed - 3.0f, 1.0f - 0.11f * seed));
+    transform.setRotation(17.3f * seed);
+    transform.setScale(Vector2(0.5f + 0.07f * (seed % 9), 1.3f - 0.05f * (seed % 7)));
+    return transform.getAffine();
+  }
+
+  static bool bitIdentical(const Affine2 &lhs, const Affine2 &rhs) {
+    return std::memcmp(&lhs, &rhs, sizeof(Affine2)) == 0;
+  }
+
+  // Build a hierarchy where node i is a child of node (i - 1) / 3
+  static std::vector<NodePtr> buildTree(int count) {
+    std::vector<NodePtr> nodes;
+    for (int i = 0; i < count; ++i) {
+      auto node = make_shared<Node>("node");
+      Transform transform;
+      transform.setAffine(makeAffine(i));
+      node->setLocalTransform(transform);
+      if (i > 0) {
+        nodes[(i - 1) / 3]->addChild(node);
+      }
+      nodes.push_back(node);
+    }
+    return nodes;
+  }
+};
+
+TEST_F(TransformBatchTest, SimdLevels_MatchScalarBitForBit) {
+  // 37 is not a multiple of any vector width, so the tails are covered too
+  const int kCount = 37;
+  AffineBatch parents;
+  AffineBatch locals;
+  for (int i = 0; i < kCount; ++i) {
+    parents.push_back(makeAffine(i));
+    locals.push_back(makeAffine(2 * i + 5));
+  }
+
+  AffineBatch expected;
+  composeAffineBatch(parents, locals, expected, SimdLevel::Scalar);
+  ASSERT_EQ(expected.size(), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_TRUE(bitIdentical(expected.get(i), parents.get(i) * locals.get(i)));
+  }
+
+  for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+    if (!isSimdLevelSupported(level)) {
+      continue;
+    }
+    AffineBatch actual;
+    composeAffineBatch(parents, locals, actual, level);
+    ASSERT_EQ(actual.size(), kCount);
+    for (int i = 0; i < kCount; ++i) {
+      EXPECT_TRUE(bitIdentical(actual.get(i), expected.get(i)))
+          << "level " << static_cast<int>(level) << ", index " << i;
+    }
+  }
+}
+
+TEST_F(TransformBatchTest, UpdateWorldTransforms_MatchesLazyPath) {
+  auto batched = buildTree(200);
+  auto lazy = buildTree(200);
+
+  updateWorldTransforms(*batched.front());
+  for (std::size_t i = 0; i < batched.size(); ++i) {
+    EXPECT_FALSE(batched[i]->isGlobalTransformDirty());
+    EXPECT_TRUE(bitIdentical(batched[i]->getGlobalTransform().getAffine(),
+                             lazy[i]->getGlobalTransform().getAffine()))
+        << "node " << i;
+  }
+}
+
+TEST_F(TransformBatchTest, UpdateWorldTransforms_OnlyRecomputesDirtySubtrees) {
+  auto nodes = buildTree(40);
+  WorldTransformUpdater updater;
+  updater.update(*nodes.front());
+
+  // Move a node deep in the tree; its sibling subtree stays cached
+  nodes[4]->setPosition(Vector2(10.0f, -2.0f));
+  EXPECT_TRUE(nodes[13]->isGlobalTransformDirty());
+  EXPECT_FALSE(nodes[5]->isGlobalTransformDirty());
+
+  updater.update(*nodes.front());
+  EXPECT_FALSE(nodes[13]->isGlobalTransformDirty());
+
+  Transform expected =
+      Transform::combine(nodes[4]->getGlobalTransform(), nodes[13]->getLocalTransform());
+  EXPECT_TRUE(bitIdentical(nodes[13]->getGlobalTransform().getAffine(),
+                           expected.getAffine()));
+}
+} // namespace scene_graph
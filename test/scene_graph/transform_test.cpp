@@ -571,4 +571,101 @@ TEST_F(TransformTest, NumericalStabilityEdgeCases) {
   EXPECT_NEAR(backToOriginal.y, testPoint.y, 1e-3f);
 }
 
-} // namespace scene_graph::test
\ No newline at end of file
+TEST_F(TransformTest, AffineMatchesMatrix4) {
+  Transform parent;
+  parent.setPosition(Vector2(3.0f, -2.0f));
+  parent.setRotation(30.0f);
+  parent.setScale(Vector2(2.0f, 0.5f));
+
+  Transform child;
+  child.setPosition(Vector2(1.0f, 4.0f));
+  child.setRotation(-75.0f);
+  child.setScale(Vector2(1.5f, 3.0f));
+
+  // Composition, inversion and point transforms agree with the 4x4 path
+  Transform combined = Transform::combine(parent, child);
+  EXPECT_TRUE(areMatricesEqual(combined.getMatrix(),
+                               parent.getMatrix() * child.getMatrix()));
+  EXPECT_TRUE(areMatricesEqual(combined.inverse().getMatrix(),
+                               glm::inverse(combined.getMatrix())));
+
+  Vector2 point(0.7f, -1.3f);
+  Vector4 expected = combined.getMatrix() * Vector4(point, 0.0f, 1.0f);
+  EXPECT_TRUE(areVectorsEqual(combined.transformPoint(point),
+                              Vector2(expected.x, expected.y)));
+  EXPECT_TRUE(areVectorsEqual(
+      combined.inverseTransformPoint(combined.transformPoint(point)), point));
+
+  // Round trip through the GPU representation is lossless
+  Affine2 affine = Affine2::fromMatrix4(combined.getMatrix());
+  EXPECT_EQ(affine.a, combined.getAffine().a);
+  EXPECT_EQ(affine.d, combined.getAffine().d);
+  EXPECT_EQ(affine.tx, combined.getAffine().tx);
+}
+
+TEST_F(TransformTest, CompactStorage) {
+  // A 3x2 affine matrix instead of a 4x4 one
+  EXPECT_EQ(sizeof(Affine2), 6 * sizeof(float));
+  EXPECT_LE(sizeof(Transform), 12 * sizeof(float));
+}
+
+TEST_F(TransformTest, CombineDecomposesLazily) {
+  Transform parent;
+  parent.setPosition(Vector2(2.0f, 1.0f));
+  parent.setRotation(90.0f);
+  Transform child;
+  child.setPosition(Vector2(1.0f, 0.0f));
+  child.setScale(Vector2(2.0f, 3.0f));
+
+  // Composing only touches the matrix
+  Transform combined = Transform::combine(parent, child);
+  EXPECT_FALSE(combined.isDecomposed());
+
+  // Copies keep the matrix without decomposing
+  Transform copy = combined;
+  EXPECT_FALSE(copy.isDecomposed());
+  EXPECT_TRUE(areMatricesEqual(copy.getMatrix(), combined.getMatrix()));
+
+  // The position is the matrix translation; the rest is extracted on
+  // first read
+  EXPECT_TRUE(areVectorsEqual(combined.getPosition(), Vector2(2.0f, 2.0f)));
+  EXPECT_FALSE(combined.isDecomposed());
+  EXPECT_NEAR(combined.getRotation(), 90.0f, kEpsilon);
+  EXPECT_TRUE(combined.isDecomposed());
+  EXPECT_TRUE(areVectorsEqual(combined.getScale(), Vector2(2.0f, 3.0f)));
+
+  // Setting one component keeps the others from the matrix
+  copy.setRotation(0.0f);
+  EXPECT_TRUE(areVectorsEqual(copy.getPosition(), Vector2(2.0f, 2.0f)));
+  EXPECT_TRUE(areVectorsEqual(copy.getScale(), Vector2(2.0f, 3.0f)));
+  EXPECT_TRUE(areVectorsEqual(copy.transformPoint(Vector2(1.0f, 1.0f)),
+                              Vector2(4.0f, 5.0f)));
+}
+
+TEST_F(TransformTest, RotationAsUnitComplex) {
+  // Composition adds angles
+  Rotation2 combined = Rotation2::fromDegrees(30.0f) * Rotation2::fromDegrees(60.0f);
+  EXPECT_NEAR(combined.toDegrees(), 90.0f, kEpsilon);
+  EXPECT_NEAR((combined * combined.inverse()).toDegrees(), 0.0f, kEpsilon);
+
+  // Normalized lerp takes the shorter arc across 0 degrees
+  Rotation2 halfway = Rotation2::nlerp(Rotation2::fromDegrees(350.0f),
+                                       Rotation2::fromDegrees(10.0f), 0.5f);
+  EXPECT_NEAR(halfway.toDegrees(), 0.0f, kEpsilon);
+
+  // Repeatedly rotating by a delta matches setting the total angle
+  Transform spun;
+  Rotation2 delta = Rotation2::fromDegrees(-1.5f);
+  for (int i = 0; i < 1000; ++i) {
+    spun.rotateBy(delta);
+  }
+  Transform direct;
+  direct.setRotation(-1500.0f);
+  EXPECT_NEAR(spun.getRotation(), direct.getRotation(), 0.01f);
+  EXPECT_NEAR(glm::length(Vector2(spun.getRotation2().cosine,
+                                  spun.getRotation2().sine)),
+              1.0f, kEpsilon);
+  EXPECT_TRUE(areMatricesEqual(spun.getMatrix(), direct.getMatrix(), 1e-3f));
+}
+
+} // namespace scene_graph::test
@@ -1,6 +1,7 @@
 #include "scene_graph/circle.h"
 #include "scene_graph/node.h"
 #include "scene_graph/rectangle.h"
+#include "scene_graph/task_scheduler.h"
 #include "types.h"
 #include "visualization/canvas.h"
 #include "visualization/renderer.h"
@@ -286,4 +287,149 @@ TEST_F(CanvasTest, HitTest_MultipleObjects_ReturnsCorrectZOrder) {
   // Should return the top-most shape (rect2)
   EXPECT_EQ(hit, rect2);
 }
-} // namespace visualization
\ No newline at end of file
+
+TEST_F(CanvasTest, HitTest_KeepsHierarchyOrder) {
+  canvas->setRoot(root);
+
+  // Overlap child1 with a child of its own and with a later sibling
+  auto grandchild = make_shared<Rectangle>("Grandchild", Vector2(1.0f, 1.0f));
+  child1->addChild(grandchild);
+  auto sibling = make_shared<Rectangle>("Sibling", Vector2(1.0f, 1.0f));
+  sibling->setPosition(Vector2(-2.5f, 0.0f));
+  root->addChild(sibling);
+
+  // A later sibling wins over an earlier one, a parent over its children
+  EXPECT_EQ(canvas->hitTest(Vector2(-2.5f, 0.0f)), sibling);
+  EXPECT_EQ(canvas->hitTest(Vector2(-1.8f, 0.0f)), child1);
+  EXPECT_EQ(canvas->hitTest(Vector2(-1.8f, 0.0f)),
+            canvas->hitTestRecursive(root, Vector2(-1.8f, 0.0f)));
+
+  // Standalone shapes win over the scene graph
+  auto overlay = make_shared<Circle>("Overlay", 0.5f);
+  overlay->setPosition(Vector2(-1.8f, 0.0f));
+  canvas->addShape(overlay);
+  EXPECT_EQ(canvas->hitTest(Vector2(-1.8f, 0.0f)), overlay);
+}
+
+TEST_F(CanvasTest, HitTest_FollowsSceneChanges) {
+  canvas->setRoot(root);
+  EXPECT_EQ(canvas->hitTest(Vector2(-2.0f, 0.0f)), child1);
+
+  // Moving and resizing refits, reparenting and removal rebuild
+  child1->setPosition(Vector2(0.0f, 6.0f));
+  EXPECT_EQ(canvas->hitTest(Vector2(-2.0f, 0.0f)), nullptr);
+  EXPECT_EQ(canvas->hitTest(Vector2(0.0f, 6.0f)), child1);
+
+  child2->setRadius(3.0f);
+  EXPECT_EQ(canvas->hitTest(Vector2(4.5f, 0.0f)), child2);
+
+  auto group = make_shared<Node>("Group");
+  group->setPosition(Vector2(10.0f, 0.0f));
+  root->addChild(group);
+  group->addChild(child1);
+  EXPECT_EQ(canvas->hitTest(Vector2(10.0f, 6.0f)), child1);
+
+  root->removeChild(child2);
+  EXPECT_EQ(canvas->hitTest(Vector2(2.0f, 0.0f)), nullptr);
+}
+
+TEST_F(CanvasTest, Render_CullsShapesOutsideView) {
+  canvas->setRoot(root);
+  canvas->render();
+  EXPECT_EQ(canvas->getRenderStats().drawn, 2u);
+  EXPECT_EQ(canvas->getRenderStats().culled, 0u);
+
+  // A whole group far outside the view is skipped with one bounds test
+  auto group = make_shared<Node>("Group");
+  group->setPosition(Vector2(100.0f, 0.0f));
+  root->addChild(group);
+  for (int i = 0; i < 3; ++i) {
+    group->addChild(make_shared<Rectangle>("Offscreen"));
+  }
+
+  // A standalone shape straddling the edge of the view is still drawn
+  auto edge = make_shared<Circle>("Edge", 1.0f);
+  edge->setPosition(Vector2(10.5f, 0.0f));
+  canvas->addShape(edge);
+
+  canvas->render();
+  const RenderStats &stats = canvas->getRenderStats();
+  EXPECT_EQ(stats.drawn, 3u);
+  EXPECT_EQ(stats.culled, 4u);
+  EXPECT_EQ(stats.culledSubtrees, 1u);
+
+  // Moving a shape out of view culls just that shape
+  child2->setPosition(Vector2(0.0f, -50.0f));
+  canvas->render();
+  EXPECT_EQ(canvas->getRenderStats().drawn, 2u);
+  EXPECT_EQ(canvas->getRenderStats().culled, 5u);
+}
+
+TEST_F(CanvasTest, Render_GathersShapesInDrawOrderWithHighlight) {
+  auto overlay = make_shared<Rectangle>("Overlay");
+  canvas->setRoot(root);
+  canvas->addShape(overlay);
+  canvas->selectNode(child2);
+  canvas->render();
+
+  // Scene graph in pre-order, then the standalone shapes
+  const auto &items = canvas->getShapeBatch().getItems();
+  ASSERT_EQ(items.size(), 3u);
+  EXPECT_EQ(items[0].shape, child1.get());
+  EXPECT_EQ(items[1].shape, child2.get());
+  EXPECT_EQ(items[2].shape, overlay.get());
+
+  // The selected shape is drawn highlighted without touching its color
+  EXPECT_EQ(items[1].color,
+            Vector4(constants::colors::NODE_SELECTED[0],
+                    constants::colors::NODE_SELECTED[1],
+                    constants::colors::NODE_SELECTED[2], child2->getColor().a));
+  EXPECT_EQ(items[0].color, child1->getColor());
+  EXPECT_NE(child2->getColor(), items[1].color);
+}
+
+TEST_F(CanvasTest, Render_SubmitsSortedCommandsWithoutGl) {
+  canvas->setRoot(root);
+  canvas->addShape(make_shared<Rectangle>("Overlay"));
+  canvas->render();
+
+  // One instanced draw per kind of opaque shape, in the scene layer
+  const auto &commands = renderer->getSubmittedCommands();
+  ASSERT_EQ(commands.size(), 2u);
+  EXPECT_EQ(commands[0].type, RenderCommandType::Shapes);
+  EXPECT_EQ(commands[0].kind, ShapeKind::Rectangle);
+  EXPECT_EQ(commands[0].count, 2u);
+  EXPECT_EQ(commands[1].kind, ShapeKind::Circle);
+  EXPECT_EQ(commands[1].count, 1u);
+  EXPECT_EQ(sort_key::layer(commands[1].key), RenderLayer::Scene);
+  EXPECT_TRUE(renderer->getRenderQueue().empty());
+}
+
+TEST_F(CanvasTest, Render_ParallelRecordingMatchesSerialOrder) {
+  // Enough children for several tasks, some out of view
+  for (int i = 0; i < 600; ++i) {
+    auto shape = i % 2 == 0 ? shared_ptr<Node>(make_shared<Rectangle>("R"))
+                            : shared_ptr<Node>(make_shared<Circle>("C", 0.1F));
+    shape->setPosition(Vector2(static_cast<float>(i % 40) - 20.0F, 0.0F));
+    root->addChild(shape);
+  }
+  canvas->setRoot(root);
+  canvas->selectNode(root->getChildren()[100]);
+  canvas->render();
+  const ShapeBatch serial = canvas->getShapeBatch();
+  const RenderStats serialStats = canvas->getRenderStats();
+
+  canvas->setTaskScheduler(make_shared<TaskScheduler>(4));
+  root->setPosition(Vector2(0.0F, 0.0F));
+  canvas->render();
+
+  const auto &items = canvas->getShapeBatch().getItems();
+  ASSERT_EQ(items.size(), serial.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(items[i].shape, serial.getItems()[i].shape);
+    EXPECT_EQ(items[i].color, serial.getItems()[i].color);
+  }
+  EXPECT_EQ(canvas->getRenderStats().drawn, serialStats.drawn);
+  EXPECT_EQ(canvas->getRenderStats().culled, serialStats.culled);
+}
+} // namespace visualization
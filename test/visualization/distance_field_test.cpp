@@ -0,0 +1,51 @@
+#include "visualization/distance_field.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace visualization {
+using namespace std;
+
+class DistanceFieldTest : public ::testing::Test {
+protected:
+  unsigned char at(const DistanceField &field, int x, int y) {
+    return field.pixels[y * field.width + x];
+  }
+};
+
+TEST_F(DistanceFieldTest, Make_PadsAndSignsDistanceFromTheOutline) {
+  // A 6x6 solid square in an 8x8 bitmap with a row pitch of 10
+  vector<unsigned char> coverage(10 * 8, 0);
+  for (int y = 1; y < 7; ++y) {
+    for (int x = 1; x < 7; ++x) {
+      coverage[y * 10 + x] = 255;
+    }
+  }
+
+  const DistanceField field = makeDistanceField(coverage.data(), 8, 8, 10, 4);
+  ASSERT_EQ(field.width, 16);
+  ASSERT_EQ(field.height, 16);
+  ASSERT_EQ(field.pixels.size(), 256u);
+
+  // Half a pixel either side of the outline, then rising inwards and
+  // falling outwards, symmetric about it
+  const int row = 8;
+  EXPECT_GT(at(field, 5, row), kDistanceFieldEdge);
+  EXPECT_LT(at(field, 4, row), kDistanceFieldEdge);
+  EXPECT_EQ(at(field, 5, row) - kDistanceFieldEdge,
+            kDistanceFieldEdge - at(field, 4, row));
+  EXPECT_GT(at(field, 7, row), at(field, 6, row));
+  EXPECT_LT(at(field, 2, row), at(field, 3, row));
+
+  // 2.5 pixels in at the middle of the square, 128 + 127 * 2.5 / 4 rounded;
+  // saturated out in the corner of the padding
+  EXPECT_EQ(at(field, 8, 8), 207);
+  EXPECT_EQ(at(field, 0, 0), 1);
+}
+
+TEST_F(DistanceFieldTest, Make_IsEmptyForEmptyBitmaps) {
+  const DistanceField field = makeDistanceField(nullptr, 0, 0, 0, 4);
+  EXPECT_EQ(field.width, 0);
+  EXPECT_TRUE(field.pixels.empty());
+}
+
+} // namespace visualization
@@ -0,0 +1,161 @@
+#include "visualization/font_cache.h"
+#include "visualization/glyph_atlas.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace visualization {
+using namespace std;
+
+class FontCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    directory = filesystem::temp_directory_path() /
+                ("font_cache_test_" + to_string(::testing::UnitTest::GetInstance()
+                                                    ->random_seed()));
+    filesystem::create_directories(directory);
+    path = (directory / "font.atlas").string();
+
+    // Two glyphs, the second on a shelf that makes the atlas grow
+    const vector<unsigned char> a(6 * 6, 200);
+    const vector<unsigned char> b(6 * 6, 100);
+    auto first = atlas.insert(6, 6, a.data(), 6);
+    auto second = atlas.insert(6, 6, b.data(), 6);
+    ASSERT_TRUE(first && second);
+    glyphs = {{U'A', 6, 6, 1, 6, 7 << 6, first->x, first->y},
+              {U'中', 6, 6, 0, 5, 8 << 6, second->x, second->y}};
+  }
+
+  void TearDown() override { filesystem::remove_all(directory); }
+
+  // Overwrite a 32-bit field of the file
+  void patch(streamoff offset, int32_t value) {
+    fstream file(path, ios::binary | ios::in | ios::out);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  filesystem::path directory;
+  string path;
+  GlyphAtlas atlas{8, 8, 64};
+  vector<CachedGlyph> glyphs;
+  FontCacheKey key{"/fonts/Sans.ttf", 1234, 24};
+};
+
+TEST_F(FontCacheTest, WriteThenOpen_RestoresAtlasAndGlyphs) {
+  ASSERT_TRUE(writeFontCache(path, key, atlas, glyphs));
+  auto cache = FontCacheFile::open(path, key);
+  ASSERT_NE(cache, nullptr);
+
+  EXPECT_EQ(cache->getAtlasWidth(), 8);
+  ASSERT_EQ(cache->getGlyphs().size(), 2u);
+  EXPECT_EQ(cache->getGlyphs()[1].codePoint, static_cast<uint32_t>(U'中'));
+  EXPECT_EQ(cache->getGlyphs()[1].atlasY, 8);
+  EXPECT_EQ(cache->getGlyphs()[1].advance, 8u << 6);
+
+  // The restored atlas carries on packing where the saved one stopped
+  GlyphAtlas restored(8, 8, 64);
+  ASSERT_TRUE(restored.restore(cache->getPackState(), cache->getPixels()));
+  EXPECT_EQ(restored.getPixels(), atlas.getPixels());
+  const vector<unsigned char> c(6 * 6, 50);
+  EXPECT_EQ(restored.insert(6, 6, c.data(), 6)->y,
+            atlas.insert(6, 6, c.data(), 6)->y);
+}
+
+TEST_F(FontCacheTest, Open_RejectsOtherFontsAndDamagedFiles) {
+  ASSERT_TRUE(writeFontCache(path, key, atlas, glyphs));
+
+  // The font changed on disk, another size, another font of the same length,
+  // distance field glyphs
+  EXPECT_EQ(FontCacheFile::open(path, {key.fontPath, 1235, 24}), nullptr);
+  EXPECT_EQ(FontCacheFile::open(path, {key.fontPath, 1234, 32}), nullptr);
+  EXPECT_EQ(FontCacheFile::open(path, {"/fonts/Mono.ttf", 1234, 24}), nullptr);
+  EXPECT_EQ(FontCacheFile::open(path, {key.fontPath, 1234, 24, true}), nullptr);
+  EXPECT_EQ(FontCacheFile::open((directory / "missing.atlas").string(), key),
+            nullptr);
+
+  filesystem::resize_file(path, filesystem::file_size(path) - 1);
+  EXPECT_EQ(FontCacheFile::open(path, key), nullptr);
+
+  EXPECT_FALSE(makeFontCacheKey((directory / "missing.ttf").string(), 24));
+}
+
+TEST_F(FontCacheTest, Open_RejectsShelvesOutsideTheAtlas) {
+  // The shelf fields follow the magic, version, path length, modified time,
+  // pixel size and atlas size
+  constexpr streamoff shelfX = 36;
+  constexpr streamoff shelfY = 40;
+  constexpr streamoff shelfHeight = 44;
+  const GlyphAtlas::PackState state = atlas.getPackState();
+
+  const vector<pair<streamoff, int32_t>> damaged = {
+      {shelfX, -1},
+      {shelfX, 9},
+      {shelfY, -1},
+      {shelfHeight, -1},
+      {shelfHeight, state.height - state.shelfY + 1},
+      {shelfY, INT32_MAX}};
+  for (const auto &[offset, value] : damaged) {
+    ASSERT_TRUE(writeFontCache(path, key, atlas, glyphs));
+    ASSERT_NE(FontCacheFile::open(path, key), nullptr);
+    patch(offset, value);
+    EXPECT_EQ(FontCacheFile::open(path, key), nullptr) << offset << " " << value;
+  }
+
+  // The atlas checks a state it is handed the same way
+  GlyphAtlas restored(8, 8, 64);
+  const vector<unsigned char> pixels(8 * 64, 0);
+  EXPECT_FALSE(restored.restore({16, -1, 8, 6}, pixels.data()));
+  EXPECT_FALSE(restored.restore({16, 0, -8, 6}, pixels.data()));
+  EXPECT_FALSE(restored.restore({16, 0, 8, -6}, pixels.data()));
+  EXPECT_FALSE(restored.restore({16, 0, INT32_MAX, 6}, pixels.data()));
+  EXPECT_FALSE(restored.restore({128, 0, 8, 6}, pixels.data()));
+  EXPECT_TRUE(restored.restore({16, 0, 8, 6}, pixels.data()));
+}
+
+TEST_F(FontCacheTest, Open_RejectsGlyphsOutsideTheAtlasAndDuplicates) {
+  const vector<CachedGlyph> valid = glyphs;
+  const auto rejects = [&](const vector<CachedGlyph> &damaged) {
+    EXPECT_TRUE(writeFontCache(path, key, atlas, damaged));
+    return FontCacheFile::open(path, key) == nullptr;
+  };
+
+  // Past the right and bottom edges; the atlas is 8 wide and 16 high
+  glyphs = valid;
+  glyphs[0].atlasX = 4;
+  EXPECT_TRUE(rejects(glyphs));
+  glyphs = valid;
+  glyphs[1].atlasY = 12;
+  EXPECT_TRUE(rejects(glyphs));
+  glyphs = valid;
+  glyphs[1].atlasY = INT32_MAX;
+  EXPECT_TRUE(rejects(glyphs));
+
+  // Negative positions and sizes
+  glyphs = valid;
+  glyphs[0].atlasX = -1;
+  EXPECT_TRUE(rejects(glyphs));
+  glyphs = valid;
+  glyphs[0].atlasY = -1;
+  EXPECT_TRUE(rejects(glyphs));
+  glyphs = valid;
+  glyphs[0].width = -1;
+  EXPECT_TRUE(rejects(glyphs));
+  glyphs = valid;
+  glyphs[1].height = -6;
+  EXPECT_TRUE(rejects(glyphs));
+
+  // A code point saved twice
+  glyphs = valid;
+  glyphs[1].codePoint = glyphs[0].codePoint;
+  EXPECT_TRUE(rejects(glyphs));
+
+  EXPECT_FALSE(rejects(valid));
+}
+
+} // namespace visualization
@@ -0,0 +1,98 @@
+#include "visualization/glyph_atlas.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace visualization {
+
+class GlyphAtlasTest : public ::testing::Test {
+protected:
+  // A bitmap filled with one value, with extra bytes at the end of each row
+  std::vector<unsigned char> bitmap(int width, int height, int pitch,
+                                    unsigned char value) {
+    std::vector<unsigned char> pixels(pitch * height, 0);
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        pixels[y * pitch + x] = value;
+      }
+    }
+    return pixels;
+  }
+};
+
+TEST_F(GlyphAtlasTest, Insert_PacksShelvesWithPadding) {
+  GlyphAtlas atlas(16, 16);
+  const auto a = bitmap(6, 4, 8, 10);
+  const auto b = bitmap(6, 6, 6, 20);
+
+  auto first = atlas.insert(6, 4, a.data(), 8);
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->x, 1);
+  EXPECT_EQ(first->y, 1);
+
+  // Second on the same shelf, after a one pixel gap
+  auto second = atlas.insert(6, 6, b.data(), 6);
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->x, 8);
+  EXPECT_EQ(second->y, 1);
+
+  // No room left on the shelf, so the next one starts below the tallest
+  auto third = atlas.insert(6, 4, a.data(), 8);
+  ASSERT_TRUE(third.has_value());
+  EXPECT_EQ(third->x, 1);
+  EXPECT_EQ(third->y, 8);
+
+  // Pixels are copied row by row, skipping the source's row padding
+  const auto &pixels = atlas.getPixels();
+  EXPECT_EQ(pixels[1 * 16 + 1], 10);
+  EXPECT_EQ(pixels[4 * 16 + 6], 10);
+  EXPECT_EQ(pixels[1 * 16 + 7], 0);
+  EXPECT_EQ(pixels[6 * 16 + 13], 20);
+  EXPECT_EQ(pixels[5 * 16 + 1], 0);
+}
+
+TEST_F(GlyphAtlasTest, Insert_FailsWhenFullAndIgnoresEmptyBitmaps) {
+  GlyphAtlas atlas(8, 8);
+  const auto big = bitmap(7, 7, 7, 1);
+  EXPECT_FALSE(atlas.insert(7, 7, big.data(), 7).has_value());
+
+  // Spaces have no pixels but still get a region
+  auto empty = atlas.insert(0, 0, nullptr, 0);
+  ASSERT_TRUE(empty.has_value());
+  EXPECT_EQ(empty->width, 0);
+
+  EXPECT_TRUE(atlas.insert(6, 6, big.data(), 7).has_value());
+  atlas.clear();
+  EXPECT_EQ(atlas.getPixels()[9], 0);
+  EXPECT_TRUE(atlas.insert(6, 6, big.data(), 7).has_value());
+}
+
+TEST_F(GlyphAtlasTest, Insert_GrowsDownwardsUpToTheMaximumHeight) {
+  GlyphAtlas atlas(8, 8, 32);
+  const auto glyph = bitmap(6, 6, 6, 30);
+
+  auto first = atlas.insert(6, 6, glyph.data(), 6);
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(atlas.getHeight(), 8);
+
+  // The next shelf starts at row 8, so the atlas doubles to fit it and the
+  // first glyph keeps its pixels and position
+  auto second = atlas.insert(6, 6, glyph.data(), 6);
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->y, 8);
+  EXPECT_EQ(atlas.getHeight(), 16);
+  EXPECT_EQ(atlas.getPixels().size(), 8u * 16u);
+  EXPECT_EQ(atlas.getPixels()[1 * 8 + 1], 30);
+  EXPECT_EQ(atlas.getPixels()[8 * 8 + 1], 30);
+
+  EXPECT_TRUE(atlas.insert(6, 6, glyph.data(), 6).has_value());
+  EXPECT_TRUE(atlas.insert(6, 6, glyph.data(), 6).has_value());
+  EXPECT_EQ(atlas.getHeight(), 32);
+  EXPECT_FALSE(atlas.insert(6, 6, glyph.data(), 6).has_value());
+  EXPECT_EQ(atlas.getHeight(), 32);
+
+  atlas.clear();
+  EXPECT_EQ(atlas.getHeight(), 8);
+  EXPECT_EQ(atlas.getPixels().size(), 64u);
+}
+
+} // namespace visualization
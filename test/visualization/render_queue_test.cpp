@@ -0,0 +1,125 @@
+#include "scene_graph/circle.h"
+#include "scene_graph/rectangle.h"
+#include "types.h"
+#include "visualization/render_queue.h"
+#include <gtest/gtest.h>
+
+namespace visualization {
+using namespace scene_graph;
+
+class RenderQueueTest : public ::testing::Test {
+protected:
+  RenderQueue queue;
+  Vector4 opaque{1.0f, 0.0f, 0.0f, 1.0f};
+  Vector4 translucent{0.0f, 1.0f, 0.0f, 0.5f};
+};
+
+TEST_F(RenderQueueTest, SortKey_RoundTripsItsFields) {
+  const auto key = sort_key::make(RenderLayer::Overlay, 5, false, 3, 7, 1234);
+  EXPECT_EQ(sort_key::layer(key), RenderLayer::Overlay);
+  EXPECT_EQ(sort_key::batch(key), 5u);
+  EXPECT_FALSE(sort_key::isTranslucent(key));
+  EXPECT_EQ(sort_key::shader(key), 3u);
+  EXPECT_EQ(sort_key::vertexArray(key), 7u);
+  EXPECT_EQ(sort_key::depth(key), 1234u);
+
+  const auto translucentKey =
+      sort_key::make(RenderLayer::Scene, sort_key::kMaxBatch + 1, true, 3, 7,
+                     sort_key::kMaxDepth + 10);
+  EXPECT_EQ(sort_key::batch(translucentKey), sort_key::kMaxBatch);
+  EXPECT_TRUE(sort_key::isTranslucent(translucentKey));
+  EXPECT_EQ(sort_key::shader(translucentKey), 3u);
+  EXPECT_EQ(sort_key::depth(translucentKey), sort_key::kMaxDepth);
+
+  // Layer first, then batch, then opaque before translucent
+  EXPECT_LT(key, sort_key::make(RenderLayer::Overlay, 5, true, 0, 0, 0));
+  EXPECT_LT(key, sort_key::make(RenderLayer::Overlay, 6, false, 0, 0, 0));
+  EXPECT_LT(translucentKey, sort_key::make(RenderLayer::Overlay, 0, false, 0, 0, 0));
+}
+
+TEST_F(RenderQueueTest, Sort_DrawsLayersInOrderAndKeepsTranslucentOrder) {
+  Rectangle rectangle("Rectangle");
+  Circle circle("Circle");
+  ShapeBatch batch;
+  batch.add(circle, translucent);
+  batch.add(rectangle, opaque);
+  batch.add(circle, opaque);
+  batch.build();
+
+  // Overlay recorded first, scene shapes after
+  queue.addText(RenderLayer::Overlay, "title", 0.0f, 0.0f, opaque);
+  queue.addRectangle(RenderLayer::Overlay, 0.0f, 0.0f, 1.0f, 1.0f, opaque);
+  queue.addShapes(batch, RenderLayer::Scene);
+  ASSERT_EQ(queue.size(), 5u);
+  queue.sort();
+
+  const auto &commands = queue.getCommands();
+  EXPECT_EQ(commands[0].type, RenderCommandType::Shapes);
+  EXPECT_EQ(commands[0].kind, ShapeKind::Rectangle);
+  EXPECT_EQ(commands[1].kind, ShapeKind::Circle);
+  EXPECT_FALSE(sort_key::isTranslucent(commands[1].key));
+  // The translucent circle blends over the opaque shapes
+  EXPECT_EQ(commands[2].kind, ShapeKind::Circle);
+  EXPECT_TRUE(sort_key::isTranslucent(commands[2].key));
+  EXPECT_EQ(commands[3].type, RenderCommandType::Text);
+  EXPECT_EQ(commands[4].type, RenderCommandType::Primitives);
+
+  EXPECT_EQ(queue.getInstances().size(), 3u);
+  EXPECT_EQ(queue.getText(queue.getTextRun(commands[3].first)), "title");
+}
+
+TEST_F(RenderQueueTest, Sort_DrawsShapesAfterEverythingRecordedBeforeThem) {
+  Rectangle rectangle("Rectangle");
+  ShapeBatch first;
+  first.add(rectangle, opaque);
+  first.build();
+  ShapeBatch second;
+  second.add(rectangle, opaque);
+  second.build();
+
+  // A line between two batches covers the first and is covered by the second
+  queue.addShapes(first, RenderLayer::Scene);
+  queue.addLine(RenderLayer::Scene, 0.0f, 0.0f, 1.0f, 0.0f, opaque, 0.1f);
+  queue.addShapes(second, RenderLayer::Scene);
+  queue.addText(RenderLayer::Scene, "label", 0.0f, 0.0f, opaque);
+  queue.sort();
+
+  const auto &commands = queue.getCommands();
+  ASSERT_EQ(commands.size(), 4u);
+  EXPECT_EQ(commands[0].type, RenderCommandType::Shapes);
+  EXPECT_EQ(commands[0].first, 0u);
+  EXPECT_EQ(commands[1].type, RenderCommandType::Primitives);
+  EXPECT_EQ(commands[2].type, RenderCommandType::Shapes);
+  EXPECT_EQ(commands[2].first, 1u);
+  EXPECT_EQ(commands[3].type, RenderCommandType::Text);
+  // Each batch is depth tested on its own
+  EXPECT_NE(sort_key::batch(commands[0].key), sort_key::batch(commands[2].key));
+}
+
+TEST_F(RenderQueueTest, AddPrimitives_SharesACommandUntilSomethingElse) {
+  queue.addRectangle(RenderLayer::Overlay, 0.0f, 0.0f, 1.0f, 1.0f, opaque);
+  queue.addLine(RenderLayer::Overlay, 0.0f, 0.0f, 1.0f, 0.0f, opaque, 0.1f);
+  // Zero-length lines add nothing
+  queue.addLine(RenderLayer::Overlay, 1.0f, 1.0f, 1.0f, 1.0f, opaque, 0.1f);
+  queue.addText(RenderLayer::Overlay, "label", 0.0f, 0.0f, opaque);
+  queue.addText(RenderLayer::Overlay, "other", 0.0f, 1.0f, opaque);
+  queue.addRectangle(RenderLayer::Overlay, 0.0f, 0.0f, 1.0f, 1.0f, opaque);
+  queue.addRectangle(RenderLayer::Scene, 0.0f, 0.0f, 1.0f, 1.0f, opaque);
+
+  const auto &commands = queue.getCommands();
+  ASSERT_EQ(commands.size(), 4u);
+  EXPECT_EQ(commands[0].first, 0u);
+  EXPECT_EQ(commands[0].count, 2u);
+  // Strings share a command the same way
+  EXPECT_EQ(commands[1].count, 2u);
+  EXPECT_EQ(queue.getText(queue.getTextRun(commands[1].first + 1)), "other");
+  EXPECT_EQ(commands[2].first, 2u);
+  EXPECT_EQ(commands[2].count, 1u);
+  EXPECT_EQ(commands[3].first, 3u);
+
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.getPrimitives().empty());
+}
+
+} // namespace visualization
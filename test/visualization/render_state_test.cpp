@@ -0,0 +1,79 @@
+#include "visualization/render_state.h"
+#include <gtest/gtest.h>
+
+namespace visualization {
+
+class RenderStateTest : public ::testing::Test {
+protected:
+  // Only the shadow state and the counters are exercised, without GL
+  void SetUp() override { state.setHeadless(true); }
+
+  RenderState state;
+};
+
+TEST_F(RenderStateTest, RepeatedBinds_AreSkipped) {
+  state.useProgram(3);
+  state.useProgram(3);
+  state.bindVertexArray(7);
+  state.bindVertexArray(7);
+  state.bindVertexArray(8);
+  state.bindArrayBuffer(2);
+  state.bindArrayBuffer(2);
+  state.setBlend(true);
+  state.setBlend(true);
+  state.setBlendFunc(1, 2);
+  state.setBlendFunc(1, 2);
+  state.setBlendFunc(1, 3);
+
+  EXPECT_EQ(state.getStats().issued, 7u);
+  EXPECT_EQ(state.getStats().skipped, 5u);
+
+  state.resetStats();
+  EXPECT_EQ(state.getStats().issued, 0u);
+  EXPECT_EQ(state.getStats().skipped, 0u);
+}
+
+TEST_F(RenderStateTest, Textures_AreTrackedPerUnit) {
+  // Without a known active unit the binding cannot be shadowed
+  state.bindTexture2D(5);
+  state.bindTexture2D(5);
+  EXPECT_EQ(state.getStats().skipped, 0u);
+
+  state.activeTexture(0);
+  state.bindTexture2D(5);
+  state.bindTexture2D(5);
+  state.activeTexture(1);
+  state.bindTexture2D(5);
+  state.activeTexture(0);
+  state.bindTexture2D(5);
+  EXPECT_EQ(state.getStats().issued, 7u);
+  EXPECT_EQ(state.getStats().skipped, 2u);
+
+  // A deleted texture is unbound from every unit
+  state.onTextureDeleted(5);
+  state.bindTexture2D(5);
+  EXPECT_EQ(state.getStats().issued, 8u);
+}
+
+TEST_F(RenderStateTest, DeletedAndInvalidatedState_IsBoundAgain) {
+  state.bindVertexArray(4);
+  state.bindArrayBuffer(6);
+  state.onVertexArrayDeleted(4);
+  state.onBufferDeleted(6);
+
+  // Recycled names are bound again; unbinding to 0 is already done by GL
+  state.bindVertexArray(0);
+  state.bindArrayBuffer(0);
+  state.bindVertexArray(4);
+  state.bindArrayBuffer(6);
+  EXPECT_EQ(state.getStats().issued, 4u);
+  EXPECT_EQ(state.getStats().skipped, 2u);
+
+  state.setDepthTest(false);
+  state.invalidate();
+  state.setDepthTest(false);
+  state.bindVertexArray(4);
+  EXPECT_EQ(state.getStats().issued, 7u);
+}
+
+} // namespace visualization
@@ -33,6 +33,37 @@ TEST_F(RendererTest, SetViewport_UpdatesDimensions) {
   SUCCEED();
 }
 
+TEST_F(RendererTest, SetViewport_KeepsViewWhenMinimized) {
+  renderer->initialize();
+  renderer->setViewport(800, 400);
+  const scene_graph::Aabb view = renderer->getViewBounds();
+  EXPECT_FLOAT_EQ(view.max.y, 5.0f);
+
+  // A minimized window reports an empty framebuffer
+  renderer->setViewport(0, 0);
+  const scene_graph::Aabb minimized = renderer->getViewBounds();
+  EXPECT_EQ(minimized.min, view.min);
+  EXPECT_EQ(minimized.max, view.max);
+  renderer->setViewport(800, 0);
+  EXPECT_EQ(renderer->getViewBounds().max, view.max);
+}
+
+TEST_F(RendererTest, SetGlyphMode_IsIgnoredOnceInitialized) {
+  FontManager fonts;
+  fonts.setGlyphMode(GlyphMode::DistanceField);
+  ASSERT_TRUE(fonts.initialize(RenderMode::Headless));
+  EXPECT_EQ(fonts.getGlyphMode(), GlyphMode::DistanceField);
+
+  // The atlas was built for the first mode
+  fonts.setGlyphMode(GlyphMode::Bitmap);
+  EXPECT_EQ(fonts.getGlyphMode(), GlyphMode::DistanceField);
+
+  // Settable again once cleaned up
+  fonts.cleanup();
+  fonts.setGlyphMode(GlyphMode::Bitmap);
+  EXPECT_EQ(fonts.getGlyphMode(), GlyphMode::Bitmap);
+}
+
 TEST_F(RendererTest, BeginFrame_ClearsBuffer) {
   renderer->initialize();
   EXPECT_NO_THROW(renderer->beginFrame());
@@ -102,4 +133,71 @@ TEST_F(RendererTest, DrawLine_VariousAngles) {
   EXPECT_NO_THROW(renderer->drawLine(0.0f, 0.0f, 0.0f, 0.0f, color));
 }
 
+TEST_F(RendererTest, DrawPrimitives_AreBatchedUntilFlush) {
+  renderer->initialize();
+  const PrimitiveStats before =
+      renderer->getShapeRenderer()->getPrimitiveStats();
+  Vector4 color(0.1f, 0.2f, 0.3f, 1.0f);
+
+  for (int i = 0; i < 100; ++i) {
+    renderer->drawRectangle(0.0f, 0.1f * i, 1.0f, 0.1f, color);
+    renderer->drawLine(0.0f, 0.1f * i, 1.0f, 0.1f * i, color);
+  }
+  // Zero-length lines have no direction and are dropped
+  renderer->drawLine(1.0f, 1.0f, 1.0f, 1.0f, color);
+  renderer->flush();
+
+  PrimitiveStats stats = renderer->getShapeRenderer()->getPrimitiveStats();
+  EXPECT_EQ(stats.quads - before.quads, 200u);
+  EXPECT_EQ(stats.drawCalls - before.drawCalls, 1u);
+
+  // Text and the end of the frame flush what is queued; empty flushes draw
+  // nothing
+  renderer->drawRectangle(0.0f, 0.0f, 1.0f, 1.0f, color);
+  renderer->drawText("label", 0.0f, 0.0f, color);
+  renderer->flush();
+  renderer->drawLine(0.0f, 0.0f, 1.0f, 1.0f, color);
+  renderer->endFrame();
+  stats = renderer->getShapeRenderer()->getPrimitiveStats();
+  EXPECT_EQ(stats.quads - before.quads, 202u);
+  EXPECT_EQ(stats.drawCalls - before.drawCalls, 3u);
+}
+
+TEST_F(RendererTest, PrimitiveBatch_ExpandsLinesAlongTheirNormal) {
+  PrimitiveBatch batch;
+  batch.addLine(0.0f, 0.0f, 2.0f, 0.0f, Vector4(1.0f), 0.2f);
+  batch.addRectangle(1.0f, 2.0f, 3.0f, 4.0f, Vector4(0.5f));
+  ASSERT_EQ(batch.getQuadCount(), 2u);
+
+  // Horizontal line: corners offset by half the thickness vertically
+  const auto &vertices = batch.getVertices();
+  EXPECT_FLOAT_EQ(vertices[0].x, 0.0f);
+  EXPECT_FLOAT_EQ(vertices[0].y, -0.1f);
+  EXPECT_FLOAT_EQ(vertices[2].x, 2.0f);
+  EXPECT_FLOAT_EQ(vertices[2].y, 0.1f);
+
+  // Rectangle: bottom-left corner first, opposite corner third
+  EXPECT_FLOAT_EQ(vertices[6].x, 1.0f);
+  EXPECT_FLOAT_EQ(vertices[6].y, 2.0f);
+  EXPECT_FLOAT_EQ(vertices[8].x, 4.0f);
+  EXPECT_FLOAT_EQ(vertices[8].y, 6.0f);
+  EXPECT_FLOAT_EQ(vertices[8].a, 0.5f);
+}
+
+TEST_F(RendererTest, BeginFrame_FillsCameraUniforms) {
+  renderer->setViewport(800, 400);
+  renderer->beginFrame();
+
+  const CameraUniforms &camera = renderer->getCameraUniforms();
+  EXPECT_EQ(camera.projection,
+            renderer->getShapeRenderer()->getProjectionMatrix());
+  // Text maps the fixed scene extents onto clip space
+  const Vector4 corner =
+      camera.textProjection * Vector4(constants::SCENE_HALF_WIDTH,
+                                      constants::SCENE_HALF_HEIGHT, 0.0f, 1.0f);
+  EXPECT_FLOAT_EQ(corner.x, 1.0f);
+  EXPECT_FLOAT_EQ(corner.y, 1.0f);
+  renderer->endFrame();
+}
+
 } // namespace visualization
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "types.h"
+#include "visualization/shader_manager.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace visualization {
+
+class ShaderManagerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Headless mode registers programs without an OpenGL context
+    ASSERT_TRUE(shaderManager.initialize(RenderMode::Headless));
+    ASSERT_TRUE(shaderManager.createShaderProgram("first", "", ""));
+    ASSERT_TRUE(shaderManager.createShaderProgram("second", "", ""));
+  }
+
+  ShaderManager shaderManager;
+};
+
+TEST_F(ShaderManagerTest, GetShaderHandle_ResolvesNamesOnce) {
+  ShaderHandle first = shaderManager.getShaderHandle("first");
+  ShaderHandle second = shaderManager.getShaderHandle("second");
+  EXPECT_TRUE(first.isValid());
+  EXPECT_TRUE(second.isValid());
+  EXPECT_NE(first.index, second.index);
+  EXPECT_FALSE(shaderManager.getShaderHandle("missing").isValid());
+
+  // Rebuilding a program keeps its handle
+  ASSERT_TRUE(shaderManager.createShaderProgram("first", "", ""));
+  EXPECT_EQ(shaderManager.getShaderHandle("first").index, first.index);
+
+  shaderManager.cleanup();
+  EXPECT_FALSE(shaderManager.getShaderHandle("first").isValid());
+}
+
+TEST_F(ShaderManagerTest, GetUniformId_InvalidForUnknownUniforms) {
+  ShaderHandle first = shaderManager.getShaderHandle("first");
+  EXPECT_FALSE(shaderManager.getUniformId(first, "projection").isValid());
+  EXPECT_FALSE(shaderManager.getUniformId(ShaderHandle{}, "projection").isValid());
+  EXPECT_FALSE(
+      shaderManager.getUniformId(ShaderHandle{42}, "projection").isValid());
+
+  // Setting an invalid uniform is a no-op, as for location -1 in GL
+  shaderManager.useShader(first);
+  EXPECT_NO_THROW(shaderManager.setUniform(UniformId{}, Matrix4(1.0f)));
+  EXPECT_NO_THROW(shaderManager.setUniform(UniformId{}, Vector4(1.0f)));
+  EXPECT_NO_THROW(shaderManager.setUniform(UniformId{}, 1.0f));
+}
+
+TEST_F(ShaderManagerTest, IsCurrent_FalseOnceTheProgramIsRebuilt) {
+  // Ids carry the link they were resolved from; find the current one
+  const ShaderHandle first = shaderManager.getShaderHandle("first");
+  auto currentGeneration = [&]() {
+    for (std::uint32_t generation = 0; generation < 16; ++generation) {
+      if (shaderManager.isCurrent(UniformId{0, first.index, generation})) {
+        return generation;
+      }
+    }
+    return ShaderHandle::kInvalid;
+  };
+  const std::uint32_t before = currentGeneration();
+  ASSERT_NE(before, ShaderHandle::kInvalid);
+
+  ASSERT_TRUE(shaderManager.createShaderProgram("first", "", ""));
+  EXPECT_FALSE(shaderManager.isCurrent(UniformId{0, first.index, before}));
+  EXPECT_NE(currentGeneration(), before);
+
+  // Nor does an id survive cleanup and a new program in the same slot
+  const std::uint32_t rebuilt = currentGeneration();
+  shaderManager.cleanup();
+  ASSERT_TRUE(shaderManager.createShaderProgram("first", "", ""));
+  EXPECT_FALSE(shaderManager.isCurrent(UniformId{0, first.index, rebuilt}));
+  EXPECT_FALSE(shaderManager.isCurrent(UniformId{0, 42, 0}));
+}
+
+} // namespace visualization
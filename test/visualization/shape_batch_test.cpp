@@ -0,0 +1,142 @@
+#include "scene_graph/circle.h"
+#include "scene_graph/rectangle.h"
+#include "types.h"
+#include "visualization/shape_batch.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace visualization {
+using namespace std;
+using namespace scene_graph;
+
+// A shape with no geometry the renderer knows how to draw
+class PlainShape : public Shape {
+public:
+  using Shape::Shape;
+  void render() const override {}
+  bool containsPoint(const Vector2 &) const override { return false; }
+};
+
+class ShapeBatchTest : public ::testing::Test {
+protected:
+  shared_ptr<Shape> addRectangle(float alpha) {
+    auto rect = make_shared<Rectangle>("rect", Vector2(2.0f, 1.0f));
+    rect->setColor(Vector4(1.0f, 0.0f, 0.0f, alpha));
+    return add(rect);
+  }
+
+  shared_ptr<Shape> addCircle(float alpha) {
+    auto circle = make_shared<Circle>("circle", 0.5f);
+    circle->setColor(Vector4(0.0f, 0.0f, 1.0f, alpha));
+    return add(circle);
+  }
+
+  shared_ptr<Shape> add(const shared_ptr<Shape> &shape) {
+    shape->setPosition(Vector2(static_cast<float>(shapes.size()), 0.0f));
+    shapes.push_back(shape);
+    batch.add(*shape, shape->getColor());
+    return shape;
+  }
+
+  // Depth of the instance drawn for the shape at the given x position
+  float depthAt(float x) const {
+    for (const ShapeInstance &instance : batch.getInstances()) {
+      if (instance.translateDepth[0] == x) {
+        return instance.translateDepth[2];
+      }
+    }
+    ADD_FAILURE() << "no instance at x = " << x;
+    return 0.0f;
+  }
+
+  void expectDepthsFollowDrawOrder() const {
+    for (size_t i = 1; i < shapes.size(); ++i) {
+      EXPECT_LT(depthAt(static_cast<float>(i)),
+                depthAt(static_cast<float>(i - 1)));
+    }
+    EXPECT_LT(depthAt(0.0f), 1.0f);
+    EXPECT_GT(depthAt(static_cast<float>(shapes.size() - 1)), -1.0f);
+  }
+
+  ShapeBatch batch;
+  vector<shared_ptr<Shape>> shapes;
+};
+
+TEST_F(ShapeBatchTest, Build_DrawsOpaqueShapesWithOneRangePerKind) {
+  for (int i = 0; i < 6; ++i) {
+    if (i % 2 == 0) {
+      addRectangle(1.0f);
+    } else {
+      addCircle(1.0f);
+    }
+  }
+  batch.build();
+
+  const auto &ranges = batch.getRanges();
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0].kind, ShapeKind::Rectangle);
+  EXPECT_EQ(ranges[0].first, 0u);
+  EXPECT_EQ(ranges[0].count, 3u);
+  EXPECT_EQ(ranges[1].kind, ShapeKind::Circle);
+  EXPECT_EQ(ranges[1].first, 3u);
+  EXPECT_EQ(ranges[1].count, 3u);
+  expectDepthsFollowDrawOrder();
+
+  // The size is folded into the instance matrix
+  const ShapeInstance &rect = batch.getInstances()[0];
+  EXPECT_FLOAT_EQ(rect.linear[0], 2.0f);
+  EXPECT_FLOAT_EQ(rect.linear[3], 1.0f);
+  const ShapeInstance &circle = batch.getInstances()[3];
+  EXPECT_FLOAT_EQ(circle.linear[0], 1.0f);
+  EXPECT_FLOAT_EQ(circle.color[2], 1.0f);
+}
+
+TEST_F(ShapeBatchTest, Build_KeepsTranslucentShapesInDrawOrder) {
+  addRectangle(1.0f);
+  addCircle(0.5f);
+  addCircle(0.5f);
+  addRectangle(0.5f);
+  addCircle(1.0f);
+  addCircle(0.5f);
+  batch.build();
+
+  // Opaque shapes first, then the translucent ones as runs of one kind
+  const auto &ranges = batch.getRanges();
+  ASSERT_EQ(ranges.size(), 5u);
+  EXPECT_EQ(ranges[0].kind, ShapeKind::Rectangle);
+  EXPECT_EQ(ranges[0].count, 1u);
+  EXPECT_EQ(ranges[1].kind, ShapeKind::Circle);
+  EXPECT_EQ(ranges[1].count, 1u);
+  EXPECT_EQ(ranges[2].kind, ShapeKind::Circle);
+  EXPECT_EQ(ranges[2].count, 2u);
+  EXPECT_EQ(ranges[3].kind, ShapeKind::Rectangle);
+  EXPECT_EQ(ranges[3].count, 1u);
+  EXPECT_EQ(ranges[4].kind, ShapeKind::Circle);
+  EXPECT_EQ(ranges[4].count, 1u);
+
+  // Translucent instances are laid out in draw order
+  EXPECT_EQ(batch.getInstances()[2].translateDepth[0], 1.0f);
+  EXPECT_EQ(batch.getInstances()[3].translateDepth[0], 2.0f);
+  EXPECT_EQ(batch.getInstances()[4].translateDepth[0], 3.0f);
+  EXPECT_EQ(batch.getInstances()[5].translateDepth[0], 5.0f);
+  expectDepthsFollowDrawOrder();
+}
+
+TEST_F(ShapeBatchTest, Add_IgnoresShapesWithoutGeometry) {
+  PlainShape shape("plain");
+  batch.add(shape, shape.getColor());
+  addCircle(1.0f);
+  batch.build();
+
+  EXPECT_EQ(batch.size(), 1u);
+  ASSERT_EQ(batch.getRanges().size(), 1u);
+
+  batch.clear();
+  batch.build();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_TRUE(batch.getInstances().empty());
+  EXPECT_TRUE(batch.getRanges().empty());
+}
+
+} // namespace visualization
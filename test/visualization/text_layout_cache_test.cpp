@@ -0,0 +1,67 @@
+#include "visualization/text_layout_cache.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace visualization {
+
+class TextLayoutCacheTest : public ::testing::Test {
+protected:
+  // A layout of the given number of glyphs
+  static TextLayout layoutOf(size_t glyphs, float width) {
+    TextLayout layout;
+    layout.vertices.resize(glyphs * 6, TextVertex{});
+    layout.width = width;
+    return layout;
+  }
+};
+
+TEST_F(TextLayoutCacheTest, Find_HitsByStringAndScale) {
+  TextLayoutCache cache;
+  EXPECT_EQ(cache.find("Root", 1.0f), nullptr);
+  cache.insert("Root", 1.0f, layoutOf(4, 2.5f));
+
+  const TextLayout *layout = cache.find("Root", 1.0f);
+  ASSERT_NE(layout, nullptr);
+  EXPECT_FLOAT_EQ(layout->width, 2.5f);
+  EXPECT_EQ(layout->vertices.size(), 24u);
+
+  // Another scale is another layout
+  EXPECT_EQ(cache.find("Root", 2.0f), nullptr);
+  EXPECT_EQ(cache.getStats().hits, 1u);
+  EXPECT_EQ(cache.getStats().misses, 2u);
+
+  // Inserting a key again replaces its layout
+  cache.insert("Root", 1.0f, layoutOf(1, 0.5f));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_FLOAT_EQ(cache.find("Root", 1.0f)->width, 0.5f);
+}
+
+TEST_F(TextLayoutCacheTest, Insert_EvictsLeastRecentlyUsedOverBudget) {
+  TextLayoutCache cache;
+  cache.insert("a", 1.0f, layoutOf(10, 1.0f));
+  const size_t perEntry = cache.getMemoryUsage();
+  cache.setBudget(perEntry * 2);
+
+  cache.insert("b", 1.0f, layoutOf(10, 1.0f));
+  // Using "a" makes "b" the oldest
+  ASSERT_NE(cache.find("a", 1.0f), nullptr);
+  cache.insert("c", 1.0f, layoutOf(10, 1.0f));
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_NE(cache.find("a", 1.0f), nullptr);
+  EXPECT_EQ(cache.find("b", 1.0f), nullptr);
+  EXPECT_NE(cache.find("c", 1.0f), nullptr);
+  EXPECT_EQ(cache.getStats().evictions, 1u);
+  EXPECT_LE(cache.getMemoryUsage(), cache.getBudget());
+
+  // A layout larger than the whole budget is still kept on its own
+  cache.insert("large", 1.0f, layoutOf(1000, 1.0f));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_NE(cache.find("large", 1.0f), nullptr);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.getMemoryUsage(), 0u);
+}
+
+} // namespace visualization
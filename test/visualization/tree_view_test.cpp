@@ -0,0 +1,58 @@
+#include "scene_graph/node.h"
+#include "types.h"
+#include "visualization/renderer.h"
+#include "visualization/tree_view.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace visualization {
+using namespace std;
+using namespace scene_graph;
+
+class TreeViewTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    renderer = make_shared<Renderer>();
+    // Enable headless mode for testing without OpenGL context
+    renderer->setHeadlessMode(true);
+    ASSERT_TRUE(renderer->initialize());
+
+    treeView.setRenderer(renderer);
+    treeView.setTextRenderer(renderer);
+  }
+
+  shared_ptr<Renderer> renderer;
+  TreeView treeView;
+};
+
+TEST_F(TreeViewTest, Render_DrawsAllRowsWithFewDrawCalls) {
+  auto root = make_shared<Node>("Root");
+  for (int i = 0; i < 50; ++i) {
+    auto group = make_shared<Node>("Group " + to_string(i));
+    group->addChild(make_shared<Node>("Leaf"));
+    root->addChild(group);
+  }
+  treeView.setRoot(root);
+  treeView.setSelectedNode(root->getChildren()[3]);
+
+  const PrimitiveStats before =
+      renderer->getShapeRenderer()->getPrimitiveStats();
+  treeView.render();
+  const PrimitiveStats after =
+      renderer->getShapeRenderer()->getPrimitiveStats();
+
+  // Background, selection and connectors in one draw; the scrollbar after
+  // the text in another
+  EXPECT_EQ(after.drawCalls - before.drawCalls, 2u);
+  // Rows scrolled out of view draw nothing, but the visible ones all do
+  EXPECT_GT(after.quads - before.quads, 20u);
+
+  // All labels go out as one text draw between the two
+  const auto &commands = renderer->getSubmittedCommands();
+  ASSERT_EQ(commands.size(), 3u);
+  EXPECT_EQ(commands[1].type, RenderCommandType::Text);
+  EXPECT_GT(commands[1].count, 10u);
+}
+
+} // namespace visualization
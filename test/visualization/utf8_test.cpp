@@ -0,0 +1,37 @@
+#include "visualization/utf8.h"
+#include <gtest/gtest.h>
+#include <string_view>
+#include <vector>
+
+namespace visualization {
+using namespace std;
+
+class Utf8Test : public ::testing::Test {
+protected:
+  vector<char32_t> decodeAll(string_view text) {
+    vector<char32_t> codePoints;
+    for (size_t i = 0; i < text.size();) {
+      codePoints.push_back(decodeUtf8(text, i));
+    }
+    return codePoints;
+  }
+};
+
+TEST_F(Utf8Test, Decode_HandlesEverySequenceLength) {
+  // A, e acute, CJK, emoji
+  const auto codePoints = decodeAll("A\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+  EXPECT_EQ(codePoints,
+            (vector<char32_t>{U'A', U'é', U'中', U'\U0001F600'}));
+}
+
+TEST_F(Utf8Test, Decode_ReplacesMalformedBytesOneAtATime) {
+  // A stray continuation byte, an overlong '/', a surrogate and a sequence
+  // cut short by the end of the string
+  const auto codePoints =
+      decodeAll("\x80x\xC0\xAFy\xED\xA0\x80z\xE4\xB8");
+  const char32_t bad = kReplacementCharacter;
+  EXPECT_EQ(codePoints, (vector<char32_t>{bad, U'x', bad, bad, U'y', bad, bad,
+                                          bad, U'z', bad, bad}));
+}
+
+} // namespace visualization